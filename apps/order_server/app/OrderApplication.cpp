@@ -40,11 +40,24 @@ std::string GenerateOrderId() {
     return "ORD-" + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
 }
 
+int FirstListenFd(const std::vector<int>& listenFds) {
+    if (listenFds.empty())
+        throw std::invalid_argument("OrderApplication requires at least one listen fd");
+    return listenFds.front();
+}
+
 }  // namespace
 
 OrderApplication::OrderApplication(EventLoop* loop, const InetAddress& listenAddr, Options options) :
     loop_(loop), httpServer_(loop, listenAddr, options.serviceName, options.enableTLS), options_(std::move(options)) {}
 
+OrderApplication::OrderApplication(EventLoop* loop, const std::vector<int>& listenFds, Options options) :
+    loop_(loop), httpServer_(loop, FirstListenFd(listenFds), options.serviceName, options.enableTLS), options_(std::move(options)), inheritedListen_(true) {
+    for (size_t i = 1; i < listenFds.size(); ++i) {
+        httpServer_.addListenFd(listenFds[i]);
+    }
+}
+
 OrderApplication::~OrderApplication() {
     stop();
 }
@@ -86,6 +99,13 @@ void OrderApplication::stop() {
 void OrderApplication::configureHttpServer() {
     const auto threads = static_cast<int>(GetThreadCount(options_.httpThreadNum));
     httpServer_.setThreadNum(threads);
+    if (!options_.extraListen.empty() && !inheritedListen_) {  // 接管的fd中已含额外监听
+        InetAddress extraAddr;
+        if (!InetAddress::parse(options_.extraListen, &extraAddr)) {
+            throw std::runtime_error("Invalid extraListen address: " + options_.extraListen);
+        }
+        httpServer_.addListenAddress(extraAddr);
+    }
 
     httpServer_.setHttpCallback([](const HttpRequest&, HttpResponse* resp) {
         resp->setStatusCode(HttpResponse::k404NotFound);
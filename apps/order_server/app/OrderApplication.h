@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "HttpServer.h"
 #include "InetAddress.h"
@@ -46,12 +47,17 @@ public:
 
     // ===== 构造与析构 =====
     explicit OrderApplication(EventLoop* loop, const InetAddress& listenAddr, Options options = Options());
+    // 热重启：接管旧进程交出的监听fd（非空，含 extraListen 的监听），不再重新绑定地址
+    OrderApplication(EventLoop* loop, const std::vector<int>& listenFds, Options options = Options());
     ~OrderApplication();
 
     // ===== 生命周期控制 =====
     void start();  // 启动整个服务（幂等）
     bool isStarted() const noexcept { return started_; }
     void stop();
+    // 热重启交接完成后：停止accept并排空在途请求，完成或超时后停止服务；监听fd已由新进程共享，只暂停不关闭
+    void drain(double timeoutSeconds) { httpServer_.drain(timeoutSeconds, true); }
+    std::vector<int> listenFds() const { return httpServer_.listenFds(); }  // 交给新进程的监听fd
     
     // ===== 对外扩展接口 =====
     MySQLConnPool* mysqlPool() const noexcept { return mysqlPool_.get(); }
@@ -97,4 +103,5 @@ private:
     std::unique_ptr<OrderQueryHandler> queryHandler_;
 
     bool started_{false};  // 防止重复启动
+    bool inheritedListen_{false};  // 监听fd接管自旧进程
 };
@@ -11,6 +11,7 @@ OrderServerOptions OrderServerOptions::FromConfig(const std::string& path) {
     opt.serviceName = cfg.get("serviceName", opt.serviceName);
     opt.enableTLS = cfg.get("enableTLS", opt.enableTLS);
     opt.httpThreadNum = cfg.get("httpThreadNum", std::max(1u, std::thread::hardware_concurrency()));
+    opt.extraListen = cfg.get("extraListen", opt.extraListen);
 
     // --------------------------- Database ---------------------------
     auto& db = opt.database;
@@ -65,6 +66,12 @@ OrderServerOptions OrderServerOptions::FromConfig(const std::string& path) {
     cache.userIndexPrefix = cfg.getPath("cache.userIndexPrefix", cache.userIndexPrefix);
     cache.detailPrefix = cfg.getPath("cache.detailPrefix", cache.detailPrefix);
 
+    // --------------------------- HotRestart ---------------------------
+    auto& restart = opt.hotRestart;
+    restart.controlAddress = cfg.getPath("hotRestart.controlAddress", restart.controlAddress);
+    restart.takeoverTimeout = cfg.getPath("hotRestart.takeoverTimeout", restart.takeoverTimeout);
+    restart.drainTimeout = cfg.getPath("hotRestart.drainTimeout", restart.drainTimeout);
+
     // --------------------------- 校验 ---------------------------
     if (!opt.validate()) {
         throw std::runtime_error("Invalid configuration detected");
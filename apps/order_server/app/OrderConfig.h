@@ -64,11 +64,21 @@ struct CacheOptions {
     std::string detailPrefix{"order:"};
 };
 
+// --------------------------- HotRestart ---------------------------
+struct HotRestartOptions {
+    std::string controlAddress;  // 新旧进程交接监听fd的控制地址（如 "unix:/run/order_server/restart.sock"，仅同一有效uid的进程可接管），空表示不启用
+    double takeoverTimeout{5.0};  // 新进程等待旧进程发来监听fd的秒数
+    double drainTimeout{30.0};  // 旧进程交出监听后排空在途请求的秒数
+
+    bool enabled() const { return !controlAddress.empty(); }
+};
+
 // --------------------------- OrderServer ---------------------------
 struct OrderServerOptions {
     std::string serviceName{"OrderServer"};
     unsigned int httpThreadNum{0};
     bool enableTLS{false};
+    std::string extraListen;  // 额外监听地址（如 "unix:/run/order_server.sock"、"unix:@order_server"、"[::]:8080"），空表示不启用
 
     MQOptions mq;
     RedisOptions redis;
@@ -77,6 +87,7 @@ struct OrderServerOptions {
     LoggingOptions logging;
     ReservationOptions reservation;
     CacheOptions cache;
+    HotRestartOptions hotRestart;
 
     bool validate() const { return !serviceName.empty() && httpThreadNum > 0 && mq.validate() && redis.validate() && database.validate(); }
 
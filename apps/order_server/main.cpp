@@ -4,12 +4,16 @@
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "app/OrderConfig.h"
 #include "app/OrderApplication.h"
 #include "EventLoop.h"
+#include "HotRestart.h"
 #include "InetAddress.h"
 
 namespace fs = std::filesystem;
@@ -82,11 +86,37 @@ int main(int argc, char* argv[]) {
 
         EventLoop loop;
         g_loop = &loop;
-        InetAddress listenAddr("0.0.0.0", 8080);
-        OrderApplication app(&loop, listenAddr, options);
+
+        // 热重启：有旧进程在运行时接过它的监听fd，否则冷启动自行绑定
+        const HotRestartOptions restartOptions = options.hotRestart;
+        InetAddress controlAddr;
+        if (restartOptions.enabled() && !InetAddress::parse(restartOptions.controlAddress, &controlAddr))
+            throw std::runtime_error("Invalid hotRestart.controlAddress: " + restartOptions.controlAddress);
+        int controlFd = -1;
+        std::vector<int> inheritedFds;
+        if (restartOptions.enabled())
+            inheritedFds = HotRestart::receiveListenFds(controlAddr, restartOptions.takeoverTimeout, &controlFd);
+
+        std::unique_ptr<OrderApplication> app;
+        if (inheritedFds.empty()) {
+            InetAddress listenAddr("0.0.0.0", 8080);
+            app = std::make_unique<OrderApplication>(&loop, listenAddr, options);
+        } else {
+            app = std::make_unique<OrderApplication>(&loop, inheritedFds, options);
+        }
 
         std::cout << "[Boot] Starting service: " << options.serviceName << std::endl;
-        app.start();
+        app->start();  // 存储/MQ就绪后才开始accept；启动失败时旧进程收不到确认，继续服务
+        if (controlFd >= 0)
+            HotRestart::confirmTakeover(controlFd);
+
+        std::shared_ptr<HotRestart> hotRestart;
+        if (restartOptions.enabled()) {
+            hotRestart = std::make_shared<HotRestart>(&loop, controlAddr);
+            hotRestart->setFdsProvider([&app] { return app->listenFds(); });
+            hotRestart->setTakeoverCallback([&app, restartOptions] { app->drain(restartOptions.drainTimeout); });
+            hotRestart->start();
+        }
 
         loop.loop();  // 启动事件循环，让 HTTP/TCP 生效
 
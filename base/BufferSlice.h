@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+// 引用计数的只读数据片段：拷贝只增加引用计数，不拷贝数据
+// owner 保证 data 指向的内存在片段存活期间有效，可用于响应头、响应体、缓存的静态内容等
+class BufferSlice {
+public:
+    BufferSlice() = default;
+
+    // 接管字符串（移动，不拷贝数据）
+    explicit BufferSlice(std::string&& str) {
+        auto holder = std::make_shared<const std::string>(std::move(str));
+        data_ = holder->data();
+        len_ = holder->size();
+        owner_ = std::move(holder);
+    }
+    // 共享已有的只读字符串（如缓存内容）
+    explicit BufferSlice(std::shared_ptr<const std::string> str) : data_(str ? str->data() : nullptr), len_(str ? str->size() : 0), owner_(std::move(str)) {}
+    // 任意内存：owner 负责保活 [data, data + len)
+    BufferSlice(std::shared_ptr<const void> owner, const char* data, size_t len) : data_(data), len_(len), owner_(std::move(owner)) {}
+
+    // 拷贝一份数据构造片段
+    static BufferSlice copyOf(const void* data, size_t len) { return BufferSlice(std::string(static_cast<const char*>(data), len)); }
+
+    // 子片段，与原片段共享同一份数据
+    BufferSlice slice(size_t offset, size_t len) const {
+        offset = std::min(offset, len_);
+        return BufferSlice(owner_, data_ + offset, std::min(len, len_ - offset));
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return len_; }
+    bool empty() const { return len_ == 0; }
+    const std::shared_ptr<const void>& owner() const { return owner_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t len_ = 0;
+    std::shared_ptr<const void> owner_;
+};
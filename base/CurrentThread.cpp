@@ -1,5 +1,9 @@
 #include "CurrentThread.h"
 
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 
 namespace CurrentThread {
@@ -10,4 +14,27 @@ namespace CurrentThread {
             t_cachedTid = static_cast<pid_t>(::syscall(SYS_gettid));
         }
     }
+
+    void setName(const std::string& name) {
+        ::prctl(PR_SET_NAME, name.substr(0, 15).c_str());
+    }
+
+    bool setAffinity(const std::vector<int>& cpus) {
+        if (cpus.empty()) {
+            return true;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (ret != 0) {
+            errno = ret;  // pthread接口通过返回值报告错误，统一为errno便于调用方记录
+            return false;
+        }
+        return true;
+    }
 }  // namespace CurrentThread
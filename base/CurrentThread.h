@@ -3,6 +3,9 @@
 
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 namespace CurrentThread {
     // 线程局部存储（TLS）缓存线程ID，避免频繁系统调用
     extern thread_local int t_cachedTid;  // TLS变量，每个线程独享一份副本
@@ -17,4 +20,11 @@ namespace CurrentThread {
         }
         return t_cachedTid;
     }
+
+    // 设置当前线程名（top -H / gdb / perf 可见，内核限制15字节，超出截断）
+    void setName(const std::string& name);
+
+    // 将当前线程绑定到cpus中的CPU，cpus为空时不做处理
+    // 绑核后再分配的内存按first-touch落在本地NUMA节点
+    bool setAffinity(const std::vector<int>& cpus);
 }  // namespace CurrentThread
@@ -0,0 +1,77 @@
+#include "SlabPool.h"
+
+#include <algorithm>
+
+namespace {
+size_t roundUpBlock(size_t size) {
+    const size_t align = alignof(std::max_align_t);
+    size = std::max(size, sizeof(void*));
+    return (size + align - 1) / align * align;
+}
+}  // namespace
+
+void* SlabPool::allocate(size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (blockSize_ == 0) {
+            blockSize_ = roundUpBlock(size);
+        }
+        if (roundUpBlock(size) == blockSize_) {
+            if (freeList_ == nullptr) {
+                grow();
+            }
+            FreeBlock* block = freeList_;
+            freeList_ = block->next;
+            peakInUse_ = std::max(peakInUse_, ++inUse_);
+            return block;
+        }
+    }
+    return ::operator new(size);  // 尺寸不符：不进池
+}
+
+void SlabPool::deallocate(void* p, size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (roundUpBlock(size) == blockSize_) {
+            auto* block = static_cast<FreeBlock*>(p);
+            block->next = freeList_;  // LIFO：最近释放的块仍在缓存中
+            freeList_ = block;
+            --inUse_;
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void SlabPool::grow() {
+    // 新slab与当前在用量相当：并发连接数翻倍时容量随之翻倍，slab个数保持在对数级
+    const size_t blocks = std::clamp(inUse_, kMinSlabBlocks, kMaxSlabBlocks);
+    slabs_.push_back(std::make_unique_for_overwrite<std::byte[]>(blocks * blockSize_));
+    std::byte* base = slabs_.back().get();
+    for (size_t i = blocks; i > 0; --i) {
+        auto* block = reinterpret_cast<FreeBlock*>(base + (i - 1) * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+    }
+    capacity_ += blocks;
+}
+
+size_t SlabPool::blockSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blockSize_;
+}
+
+size_t SlabPool::inUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inUse_;
+}
+
+size_t SlabPool::peakInUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peakInUse_;
+}
+
+size_t SlabPool::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
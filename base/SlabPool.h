@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "NonCopyable.h"
+
+/**
+ * SlabPool: 定长内存块池
+ * - 按slab批量向系统申请，释放的块挂回空闲链表复用，稳态下分配/回收不经过malloc
+ * - 新slab的块数取当前在用块数（至少 kMinSlabBlocks），容量随观测到的并发量倍增，最终与峰值同量级
+ * - 块大小在首次分配时确定，尺寸不符的请求退回 operator new
+ * - 任意线程可调用（连接常在主loop分配、在ioLoop释放），内部以互斥锁保护
+ * slab 在池析构时才归还系统：池由 shared_ptr 持有，未释放的块经 SlabAllocator 间接引用池
+ */
+class SlabPool : NonCopyable {
+public:
+    static constexpr size_t kMinSlabBlocks = 16;
+    static constexpr size_t kMaxSlabBlocks = 4096;
+
+    SlabPool() = default;
+    ~SlabPool() = default;
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+    // ==== 统计（任意线程）====
+    size_t blockSize() const;
+    size_t inUse() const;  // 已分配未归还的块数
+    size_t peakInUse() const;  // 在用块数峰值
+    size_t capacity() const;  // 所有slab的块数
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void grow();  // 追加一个slab，需持有 mutex_
+
+    mutable std::mutex mutex_;
+    size_t blockSize_ = 0;  // 0表示尚未确定
+    FreeBlock* freeList_ = nullptr;
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    size_t capacity_ = 0;
+    size_t inUse_ = 0;
+    size_t peakInUse_ = 0;
+};
+
+/**
+ * SlabAllocator: 从 SlabPool 分配单个对象的分配器，配合 std::allocate_shared 使用，
+ * 使控制块与对象落在同一个池化块中；分配器副本随控制块保存，保证池比块活得久
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(std::shared_ptr<SlabPool> pool) : pool_(std::move(pool)) {}
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>& other) : pool_(other.pool_) {}
+
+    T* allocate(size_t n) {
+        if (n == 1 && alignof(T) <= alignof(std::max_align_t)) {
+            return static_cast<T*>(pool_->allocate(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (n == 1 && alignof(T) <= alignof(std::max_align_t)) {
+            pool_->deallocate(p, sizeof(T));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U>& other) const { return pool_ == other.pool_; }
+
+private:
+    template <typename U>
+    friend class SlabAllocator;
+
+    std::shared_ptr<SlabPool> pool_;
+};
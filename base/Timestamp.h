@@ -43,4 +43,72 @@ public:
     int64_t getMicroSecondsSinceEpoch() const{
         return microSecondsSinceEpoch_;
     }
+
+    // 是否为有效时间戳（默认构造的0视为无效）
+    bool valid() const { return microSecondsSinceEpoch_ > 0; }
+    static Timestamp invalid() { return Timestamp(); }
+
+    static const int kMicroSecondsPerSecond = 1000 * 1000;
+};
+
+inline bool operator<(Timestamp lhs, Timestamp rhs) {
+    return lhs.getMicroSecondsSinceEpoch() < rhs.getMicroSecondsSinceEpoch();
+}
+
+inline bool operator==(Timestamp lhs, Timestamp rhs) {
+    return lhs.getMicroSecondsSinceEpoch() == rhs.getMicroSecondsSinceEpoch();
+}
+
+// 两个时间戳之差（秒）
+inline double timeDifference(Timestamp high, Timestamp low) {
+    int64_t diff = high.getMicroSecondsSinceEpoch() - low.getMicroSecondsSinceEpoch();
+    return static_cast<double>(diff) / Timestamp::kMicroSecondsPerSecond;
+}
+
+// 在时间戳上累加秒数，返回新的时间戳
+inline Timestamp addTime(Timestamp timestamp, double seconds) {
+    int64_t delta = static_cast<int64_t>(seconds * Timestamp::kMicroSecondsPerSecond);
+    return Timestamp(timestamp.getMicroSecondsSinceEpoch() + delta);
+}
+
+// MonoTimestamp: 单调时钟时间戳（微秒，起点为系统启动），用于时长、超时与截止时间
+// 不受系统时间调整（NTP跳变、手动改时间）影响；不能转换为日历时间
+class MonoTimestamp {
+private:
+    int64_t microSeconds_;  // 单调时钟起点以来的微秒数
+
+public:
+    using Clock = std::chrono::steady_clock;  // Linux 下为 CLOCK_MONOTONIC，与 timerfd 一致
+
+    MonoTimestamp() : microSeconds_(0) {}
+    explicit MonoTimestamp(int64_t microSeconds) : microSeconds_(microSeconds) {}
+
+    static MonoTimestamp now() {
+        return MonoTimestamp(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count());
+    }
+    int64_t getMicroSeconds() const { return microSeconds_; }
+
+    bool valid() const { return microSeconds_ > 0; }
+    static MonoTimestamp invalid() { return MonoTimestamp(); }
 };
+
+inline bool operator<(MonoTimestamp lhs, MonoTimestamp rhs) {
+    return lhs.getMicroSeconds() < rhs.getMicroSeconds();
+}
+
+inline bool operator==(MonoTimestamp lhs, MonoTimestamp rhs) {
+    return lhs.getMicroSeconds() == rhs.getMicroSeconds();
+}
+
+inline double timeDifference(MonoTimestamp high, MonoTimestamp low) {
+    return static_cast<double>(high.getMicroSeconds() - low.getMicroSeconds()) / Timestamp::kMicroSecondsPerSecond;
+}
+
+inline int64_t microsDifference(MonoTimestamp high, MonoTimestamp low) {
+    return high.getMicroSeconds() - low.getMicroSeconds();
+}
+
+inline MonoTimestamp addTime(MonoTimestamp timestamp, double seconds) {
+    int64_t delta = static_cast<int64_t>(seconds * Timestamp::kMicroSecondsPerSecond);
+    return MonoTimestamp(timestamp.getMicroSeconds() + delta);
+}
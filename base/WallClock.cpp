@@ -0,0 +1,50 @@
+#include "WallClock.h"
+
+#include <stdio.h>
+#include <time.h>
+
+namespace WallClock {
+    namespace {
+        struct Cache {
+            int64_t seconds = -1;  // 缓存内容对应的秒，-1表示尚未格式化
+            size_t length = 0;
+            char buf[32];
+        };
+
+        thread_local Cache t_localTime;
+        thread_local Cache t_httpDate;
+    }  // namespace
+
+    std::string_view localTime(int64_t secondsSinceEpoch) {
+        Cache& cache = t_localTime;
+        if (cache.seconds != secondsSinceEpoch) {
+            time_t t = static_cast<time_t>(secondsSinceEpoch);
+            struct tm tm;
+            ::localtime_r(&t, &tm);
+            cache.length = ::strftime(cache.buf, sizeof cache.buf, "%Y-%m-%d %H:%M:%S", &tm);
+            cache.seconds = secondsSinceEpoch;
+        }
+        return std::string_view(cache.buf, cache.length);
+    }
+
+    std::string_view httpDate(int64_t secondsSinceEpoch) {
+        Cache& cache = t_httpDate;
+        if (cache.seconds != secondsSinceEpoch) {
+            time_t t = static_cast<time_t>(secondsSinceEpoch);
+            struct tm tm;
+            ::gmtime_r(&t, &tm);
+            // HTTP 要求英文星期与月份，不能用依赖 locale 的 %a/%b
+            static const char* const kDays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+            static const char* const kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+            int n = ::snprintf(cache.buf, sizeof cache.buf, "%s, %02d %s %04d %02d:%02d:%02d GMT", kDays[tm.tm_wday], tm.tm_mday,
+                               kMonths[tm.tm_mon], tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+            cache.length = n > 0 ? static_cast<size_t>(n) : 0;
+            cache.seconds = secondsSinceEpoch;
+        }
+        return std::string_view(cache.buf, cache.length);
+    }
+
+    std::string_view httpDate() {
+        return httpDate(static_cast<int64_t>(::time(nullptr)));
+    }
+}  // namespace WallClock
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string_view>
+
+/**
+ * WallClock: 按秒缓存的日历时间字符串（每线程一份）
+ * 日志与 HTTP Date 头每次都要格式化当前时间，而 localtime_r/gmtime_r + strftime 的开销远大于读时钟；
+ * 同一秒内直接返回缓存，跨秒时才重新格式化，因此每个线程每秒最多格式化一次
+ * 返回的 string_view 指向线程局部缓冲，在本线程下一次调用同一函数之前有效
+ */
+namespace WallClock {
+    // 本地时间 "YYYY-mm-dd HH:MM:SS"
+    std::string_view localTime(int64_t secondsSinceEpoch);
+
+    // HTTP Date 头格式（IMF-fixdate，GMT）："Sun, 06 Nov 1994 08:49:37 GMT"
+    std::string_view httpDate(int64_t secondsSinceEpoch);
+    std::string_view httpDate();  // 当前时间
+}  // namespace WallClock
@@ -1,40 +1,84 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "Channel.h"
+#include "InetAddress.h"
 #include "NonCopyable.h"
 #include "Socket.h"
+#include "SocketOptions.h"
 
 class EventLoop;
-class InetAddress;
 
-class Acceptor : NonCopyable {
+// 须由 shared_ptr 持有：跨线程的暂停/恢复与ET模式的续接任务只持有弱引用，acceptor 可能先于任务执行被销毁
+class Acceptor : NonCopyable, public std::enable_shared_from_this<Acceptor> {
 public:
     using NewConnectionCallback = std::function<void(int sockfd, const InetAddress&)>;
 
+    // 一次可读事件中接受到的连接
+    struct AcceptedConnection {
+        int sockfd;
+        InetAddress peerAddr;
+    };
+    using AcceptedList = std::vector<AcceptedConnection>;
+    using NewConnectionBatchCallback = std::function<void(const AcceptedList&)>;
+    // 返回当前还允许接受的连接数，用于在批量accept中精确执行连接上限
+    using AcceptQuotaCallback = std::function<size_t()>;
+
     Acceptor(EventLoop* loop, const InetAddress& listenAddr, bool reuseport);
+    // 接管已绑定（通常已在监听）的套接字，如热重启时从旧进程收到的fd；Acceptor 析构时关闭它
+    Acceptor(EventLoop* loop, int listenFd);
     ~Acceptor();
     
-    // 监听本地端口
+    // 监听本地端口（可在任意线程调用，Channel注册总在所属loop中完成）
     void listen();
     // 判断是否在监听
     bool listenning() const { return listenning_; }
     // 设置新连接的回调函数
     void setNewConnectionCallback(const NewConnectionCallback& cb) { NewConnectionCallback_ = cb; }
+    // 设置批量回调：一次事件接受的所有连接一并交付（优先于逐个回调）
+    void setNewConnectionBatchCallback(const NewConnectionBatchCallback& cb) { newConnectionBatchCallback_ = cb; }
+    // 每次可读事件最多accept的连接数
+    void setMaxAcceptsPerEvent(size_t n) { maxAcceptsPerEvent_ = n > 0 ? n : 1; }
+    void setAcceptQuotaCallback(const AcceptQuotaCallback& cb) { acceptQuotaCallback_ = cb; }
+    // 监听套接字选项（backlog、TCP_FASTOPEN、TCP_DEFER_ACCEPT、收发缓冲区），需在listen()之前设置
+    void setSocketOptions(const SocketOptions& opts) { socketOptions_ = opts; }
+    // 边缘触发：每次事件循环accept直到EAGAIN（需在listen()之前设置）
+    void setEdgeTriggered(bool on) { acceptChannel_.setEdgeTriggered(on); }
+
+    EventLoop* getLoop() const { return loop_; }
+    const InetAddress& listenAddress() const { return listenAddr_; }
+    bool adopted() const { return adopted_; }  // 是否由已有fd构造
+    Socket& socket() { return acceptSocket_; }  // 用于设置 reuseport 分流等监听套接字选项
+
+    // 暂停/恢复accept（线程安全）：暂停期间新连接留在内核全连接队列中，形成反压
+    void pause();
+    void resume();
 
 private:
     // ==== 核心组件 ====
     EventLoop* loop_;  // 所属事件循环（必须首位）
     Socket acceptSocket_;  // 监听套接字（依赖loop_）
     Channel acceptChannel_;  // 监听channel（依赖acceptSocket_）
+    const InetAddress listenAddr_;  // 监听地址
 
     // ==== 运行时状态 ====
+    const bool adopted_;  // 接管的已有监听套接字
     bool listenning_;  // 监听状态标志
+    bool paused_;  // 是否暂停accept
+    size_t maxAcceptsPerEvent_;  // 每次事件的accept上限
+    SocketOptions socketOptions_;  // listen() 时应用的套接字选项
+    int idleFd_;  // 预留的空闲fd，fd耗尽(EMFILE)时腾出一个用于接受并立即关闭新连接
+    AcceptedList accepted_;  // 本次事件接受的连接（复用内存）
 
     // ==== 回调接口 ====
     NewConnectionCallback NewConnectionCallback_;  // 新连接到达回调
+    NewConnectionBatchCallback newConnectionBatchCallback_;  // 批量新连接回调
+    AcceptQuotaCallback acceptQuotaCallback_;  // 接受配额
 
     // ==== 内部方法 ====
     void handleRead();  // 处理可读事件（接受新连接）
+    bool rejectOnFdExhausted();  // 用预留fd接受并关闭一个连接，失败返回false
 };
\ No newline at end of file
@@ -28,3 +28,6 @@ using HighWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t
 
 // 数据到达回调（带缓冲区和时间戳）
 using MessageCallback = std::function<void(const TcpConnectionPtr&, Buffer*, Timestamp)>;  // 接收到新数据时触发（带接收缓冲区和时间戳）
+
+// 定时器回调
+using TimerCallback = std::function<void()>;  // 定时器到期时触发
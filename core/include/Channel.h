@@ -59,6 +59,12 @@ public:
         events_ &= ~kWriteEvent;
         update();
     }
+    void enableAll() {  // 同时启用读写监听（ET模式下一次注册，之后无需再MOD写事件）
+        if (fd_ < 0)
+            return;
+        events_ |= kReadEvent | kWriteEvent;
+        update();
+    }
     void disableAll() {  // 禁用所有监听
         if (fd_ < 0)
             return;
@@ -66,6 +72,10 @@ public:
         update();
     }
 
+    // 边缘触发（EPOLLET）：需在首次注册前设置，仅 epoll 后端生效
+    void setEdgeTriggered(bool on) { edgeTriggered_ = on; }
+    bool isEdgeTriggered() const { return edgeTriggered_; }
+
     // 事件状态查询
     bool isNoneEvent() const { return events_ == kNoneEvent; }  // 是否无监听事件
     bool isWriting() const { return events_ & kWriteEvent; }  // 是否监听写事件
@@ -84,6 +94,7 @@ private:
     int events_;  // 注册监听的事件（EPOLLIN/EPOLLOUT等）
     int revents_;  // Poller返回的实际发生事件
     int index_;  // 在Poller中的状态索引（如EPOLL_CTL_ADD/MOD）
+    bool edgeTriggered_;  // 是否以边缘触发方式注册
 
     // ==== 资源安全控制 ====
     std::weak_ptr<void> tie_;  // 弱引用绑定，防止回调时Channel被销毁
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <random>
+
+#include "InetAddress.h"
+#include "NonCopyable.h"
+#include "TimerId.h"
+
+class Channel;
+class EventLoop;
+
+/**
+ * Connector: 非阻塞主动连接器（TcpClient / TcpConnectionPool 内部使用）
+ * - connect 返回 EINPROGRESS 后关注可写事件，可写时以 SO_ERROR 判定结果
+ * - 连接超时由所属 loop 的定时器控制
+ * - 失败后按指数退避重试，退避时间带随机抖动（[delay/2, delay]），避免大量客户端同时重连
+ * 成功后把已连接的 sockfd 交给 NewConnectionCallback，Connector 不再持有它
+ * 除 start/stop 外的方法仅在所属 loop 线程调用
+ */
+class Connector : NonCopyable, public std::enable_shared_from_this<Connector> {
+public:
+    using NewConnectionCallback = std::function<void(int sockfd)>;
+    using ConnectFailedCallback = std::function<void()>;
+
+    Connector(EventLoop* loop, const InetAddress& serverAddr);
+    ~Connector();
+
+    void setNewConnectionCallback(const NewConnectionCallback& cb) { newConnectionCallback_ = cb; }
+    // 用尽重试次数后回调（maxAttempts 为 0 时永不触发）
+    void setConnectFailedCallback(const ConnectFailedCallback& cb) { connectFailedCallback_ = cb; }
+
+    // 以下配置需在 start() 之前设置
+    void setConnectTimeout(double seconds) { connectTimeout_ = seconds; }  // <=0 表示只依赖内核超时
+    void setRetryDelay(double initialSeconds, double maxSeconds);  // 退避的初始值与上限
+    void setMaxAttempts(int n) { maxAttempts_ = n; }  // 单轮 start 的最大尝试次数，0 表示无限重试
+
+    const InetAddress& serverAddress() const { return serverAddr_; }
+
+    void start();  // 任意线程
+    void restart();  // 仅loop线程：重置退避后重新连接（TcpClient 断线重连）
+    void stop();  // 任意线程
+
+private:
+    enum States { kDisconnected, kConnecting, kConnected };
+
+    void setState(States s) { state_ = s; }
+    void startInLoop();
+    void stopInLoop();
+    void connect();
+    void connecting(int sockfd);
+    void handleWrite();
+    void handleError();
+    void handleTimeout();
+    void retry(int sockfd);
+    int removeAndResetChannel();
+    void resetChannel();
+    void cancelTimer(TimerId* timer);
+    double nextRetryDelay();  // 带抖动的本次等待时间，并把退避翻倍
+
+    EventLoop* loop_;
+    const InetAddress serverAddr_;
+    bool connect_;  // 是否仍需连接（stop 后为 false）
+    States state_;
+    std::unique_ptr<Channel> channel_;  // 连接中的 socket 通道，完成后交出 fd 并销毁
+
+    // ==== 重试与超时 ====
+    double connectTimeout_;
+    double initRetryDelay_;
+    double maxRetryDelay_;
+    double retryDelay_;  // 当前退避时间（秒）
+    int maxAttempts_;
+    int attempts_;  // 本轮已尝试次数
+    TimerId retryTimer_;
+    TimerId timeoutTimer_;
+    std::minstd_rand rng_;  // 退避抖动
+
+    NewConnectionCallback newConnectionCallback_;
+    ConnectFailedCallback connectFailedCallback_;
+};
@@ -17,9 +17,10 @@ public:
     EPollPoller(EventLoop* loop);
     ~EPollPoller() override;
 
-    Timestamp poll(int timeoutMs, ChannelList* activeChannels) override;
+    MonoTimestamp poll(int timeoutMs, ChannelList* activeChannels) override;
     void updateChannel(Channel* channel) override;
     void removeChannel(Channel* channel) override;
+    bool supportsEdgeTriggered() const override { return true; }
 
 private:
     using EventList = std::vector<epoll_event>;
@@ -32,5 +33,6 @@ private:
 
     // ==== 内部方法 ====
     void fillActiveChannels(int numEvents, ChannelList* activeChannels) const;
-    void update(int operation, Channel* channel);
+    void update(int operation, Channel* channel, ChannelSlot* slot);
+    static uint32_t interestOf(const Channel* channel);  // channel期望注册的事件掩码（含EPOLLET）
 };
\ No newline at end of file
@@ -4,15 +4,21 @@
 #include <format>
 #include <functional>
 #include <memory>
-#include <mutex>
 #include <vector>
 
+#include "Callbacks.h"
 #include "CurrentThread.h"
+#include "LoopStats.h"
+#include "MpscTaskQueue.h"
 #include "NonCopyable.h"
+#include "SlabPool.h"
+#include "TimerId.h"
 #include "Timestamp.h"
 
 class Channel;
 class Poller;
+class TimerQueue;
+class TimingWheel;
 
 // 事件循环类 主要包含了两个大模块 Channel Poller(epoll的抽象)
 class EventLoop : NonCopyable {
@@ -25,14 +31,50 @@ public:
     void quit();
 
     Timestamp pollReturnTime() const { return pollReturnTime_; }
+
+    // ==== 缓存时钟 ====
+    // 本轮poll返回时读取一次单调时钟，IO回调与定时器回调直接读取缓存，无需再访问时钟（仅限loop线程）
+    MonoTimestamp now() const { return cachedNow_; }
+    // 当前线程的loop缓存的时间；线程中没有EventLoop时直接读取时钟
+    static MonoTimestamp cachedNow();
     void runInLoop(Functor&& cb);  // 在当前loop中执行
     void queueInLoop(Functor&& cb);  // 把上层注册的回调函数cb放入队列中 唤醒loop所在的线程执行cb
     void wakeup();  // 通过eventfd唤醒loop对应的线程
 
+    // ==== 定时器接口（线程安全）====
+    TimerId runAt(Timestamp time, TimerCallback cb);  // 在指定时间点执行cb
+    TimerId runAt(MonoTimestamp time, TimerCallback cb);  // 在指定的单调时间点（截止时间）执行cb
+    TimerId runAfter(double delay, TimerCallback cb);  // delay秒后执行cb
+    TimerId runEvery(double interval, TimerCallback cb);  // 每隔interval秒执行一次cb
+    void cancel(TimerId timerId);  // 取消定时器
+
+    // 连接超时管理使用的分层时间轮（仅限loop线程访问）
+    TimingWheel* timingWheel() const { return timingWheel_.get(); }
+
     // EventLoop的方法 => Poller的方法
     void updateChannel(Channel* channel);
     void removeChannel(Channel* channel);
     bool hasChannel(Channel* channel);
+    bool supportsEdgeTriggered() const;
+
+    // 自适应忙轮询（线程安全）：每轮先以0超时poll并检查任务队列，最多自旋maxSpinMicros微秒再阻塞等待
+    // 自旋无果时预算减半、命中时翻倍，空闲的loop会自动退化为接近纯阻塞；<=0 关闭
+    void setBusyPoll(int64_t maxSpinMicros);
+    int64_t spinMicros() const { return spinMicros_.load(std::memory_order_relaxed); }  // 累计自旋时长
+    int64_t sleepMicros() const { return sleepMicros_.load(std::memory_order_relaxed); }  // 累计阻塞等待时长
+
+    // ==== 负载指标（任意线程可读，供连接分配策略使用）====
+    void connectionAdded() { connectionCount_.fetch_add(1, std::memory_order_relaxed); }
+    void connectionRemoved() { connectionCount_.fetch_sub(1, std::memory_order_relaxed); }
+    int connectionCount() const { return connectionCount_.load(std::memory_order_relaxed); }  // 归属本loop的连接数
+    int64_t busyMicros() const { return busyMicros_.load(std::memory_order_relaxed); }  // 每轮处理耗时（EWMA，微秒）
+
+    // ==== 运行统计 ====
+    LoopStats stats() const { return stats_.snapshot(); }  // 任意线程：累计计数的快照，两次快照相减即为区间统计
+    void recordTimerLag(int64_t micros) { stats_.recordTimerLag(micros); }  // 仅限loop线程，由TimerQueue调用
+
+    // 归属本loop的连接对象的内存池（任意线程可分配）：连接与其控制块同块分配，销毁后块回到池中复用
+    const std::shared_ptr<SlabPool>& connectionSlab() const { return connectionSlab_; }
 
     // 判断EventLoop对象是否在自己线程里：
     // threadId_为创建EventLoop对象的线程id; t_cachedTid为当前线程id；
@@ -46,19 +88,41 @@ private:
     // ==== Poller 相关 ====
     using ChannelList = std::vector<Channel*>;
     std::unique_ptr<Poller> poller_;  // Poller 实例（epoll抽象）
-    Timestamp pollReturnTime_;  // Poller返回事件的时间戳
+    Timestamp pollReturnTime_;  // Poller返回事件的时间戳（由 cachedNow_ 推算的日历时间）
+    MonoTimestamp cachedNow_;  // 本轮缓存的单调时间
+    Timestamp wallBase_;  // 日历时间基准，每秒按系统时钟校准一次（NTP跳变最多滞后1秒生效）
+    MonoTimestamp wallBaseMono_;  // 校准时刻的单调时间
     ChannelList activeChannels_;  // 当前活跃的Channel列表
+    std::unique_ptr<TimerQueue> timerQueue_;  // 定时器队列（timerfd驱动）
+    std::unique_ptr<TimingWheel> timingWheel_;  // 连接超时时间轮（依赖timerQueue_）
 
     // ==== 跨线程任务调度 ====
     int wakeupFd_;  // 用于唤醒的事件fd
     std::unique_ptr<Channel> wakeupChannel_;  // 绑定wakeupFd_的Channel
-    std::vector<Functor> pendingFunctors_;  // 待执行的回调队列
+    MpscTaskQueue pendingFunctors_;  // 待执行的回调队列（无锁MPSC）
     std::atomic_bool callingPendingFunctors_;  // 是否正在执行回调
-    std::mutex mutex_;  // 保护pendingFunctors_的锁
+    std::atomic_bool wakeupPending_;  // eventfd已写入且loop尚未开始处理，合并重复唤醒
+
+    // ==== 忙轮询 ====
+    int64_t busyPollMaxMicros_;  // 自旋预算上限（0表示关闭）
+    int64_t spinBudgetMicros_;  // 当前自旋预算（自适应）
+    std::atomic<int64_t> spinMicros_;  // 累计自旋时长
+    std::atomic<int64_t> sleepMicros_;  // 累计阻塞时长
+
+    // ==== 负载指标 ====
+    std::atomic_int connectionCount_;  // 活跃连接数
+    std::atomic<int64_t> busyMicros_;  // 事件处理+回调执行耗时的EWMA
+    LoopStatsRecorder stats_;  // 运行统计（只由loop线程写入）
+
+    // ==== 内存池 ====
+    std::shared_ptr<SlabPool> connectionSlab_;  // 连接对象池（块可能晚于loop释放，故共享持有）
 
     // ==== 内部方法 ====
     void handleRead();  // 处理wakeupFd_的可读事件
-    void doPendingFunctors();  // 执行回调队列
+    MonoTimestamp doPendingFunctors(MonoTimestamp start);  // 执行回调队列，返回执行完毕的时间
+    void wakeupIfNeeded();  // 仅在没有未处理的唤醒时写eventfd
+    MonoTimestamp busyPoll();  // 忙轮询模式下的一次poll
+    Timestamp wallTime(MonoTimestamp mono);  // 单调时间 => 日历时间，不读系统时钟（每秒校准一次除外）
 };
 
 namespace std {
@@ -17,6 +17,8 @@ public:
     EventLoopThread(const ThreadInitCallback& cb = ThreadInitCallback(), const std::string& name = std::string());
     ~EventLoopThread();
 
+    void setCpuAffinity(std::vector<int> cpus) { thread_.setCpuAffinity(std::move(cpus)); }  // 需在startLoop()之前设置
+
     EventLoop* startLoop();
 
 private:
@@ -2,9 +2,11 @@
 
 #include <functional>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 
+#include "LoopStats.h"
 #include "NonCopyable.h"
 class EventLoop;
 class EventLoopThread;
@@ -12,19 +14,39 @@ class EventLoopThread;
 class EventLoopThreadPool : NonCopyable {
 public:
     using ThreadInitCallback = std::function<void(EventLoop*)>;
+    // 自定义分配函数：从候选subloop中选出一个
+    using PlacementFunction = std::function<EventLoop*(const std::vector<EventLoop*>& loops)>;
+
+    // 新连接分配策略
+    enum PlacementPolicy {
+        kRoundRobin,  // 轮询（默认）
+        kLeastConnections,  // 活跃连接数最少
+        kLeastLatency,  // 最近每轮处理耗时最短
+        kPowerOfTwoChoices,  // 随机取两个，选连接数较少者
+    };
 
     EventLoopThreadPool(EventLoop* baseLoop, const std::string& nameArg);
     ~EventLoopThreadPool();
 
     void setThreadNum(int numThreads) { numThreads_ = numThreads; }
+    void setPlacementPolicy(PlacementPolicy policy) { policy_ = policy; }
+    void setPlacementFunction(PlacementFunction fn) { placementFunction_ = std::move(fn); }  // 优先于policy_
+    // 第i个subloop线程绑定到 cpus[i % cpus.size()]，需在start()之前设置
+    void setCpuList(std::vector<int> cpus) { cpus_ = std::move(cpus); }
+    // 第index个subloop绑定的CPU，未设置绑核时返回-1
+    int cpuOf(size_t index) const { return cpus_.empty() ? -1 : cpus_[index % cpus_.size()]; }
 
     void start(const ThreadInitCallback& cb = ThreadInitCallback());
 
-    // 如果工作在多线程中，baseLoop_(mainLoop)会默认以轮询的方式分配Channel给subLoop
+    // 如果工作在多线程中，baseLoop_(mainLoop)按分配策略（默认轮询）分配Channel给subLoop
     EventLoop* getNextLoop();
 
     std::vector<EventLoop*> getAllLoops();  // 获取所有的EventLoop
 
+    // ==== 运行统计（任意线程，start之后调用）====
+    std::vector<LoopStats> getAllStats();  // 与 getAllLoops() 一一对应，用于发现热点loop
+    LoopStats aggregateStats();  // 所有loop汇总，用于判断loop总数是否够用
+
     bool isStarted() const { return started_; }  // 是否已经启动
     const std::string getName() const { return name_; }  // 获取名字
 
@@ -37,10 +59,20 @@ private:
     bool started_;  // 启动状态
     int numThreads_;  // 线程数量
     size_t next_;  // 轮询索引
+    std::vector<int> cpus_;  // 绑核列表
+    PlacementPolicy policy_;  // 分配策略
+    PlacementFunction placementFunction_;  // 自定义分配函数
+    std::minstd_rand rng_;  // 二选一策略的随机源（只在baseLoop_中使用）
 
     // ==== 线程资源 ====
     std::vector<std::unique_ptr<EventLoopThread>> threads_;  // 线程列表
     std::vector<EventLoop*> loops_;  // 子事件循环列表
 
     // 注：不再需要单独的ThreadInitCallback成员，因其仅在start()参数中使用
+
+    // ==== 内部方法 ====
+    EventLoop* roundRobin();
+    EventLoop* leastConnections();
+    EventLoop* leastLatency();
+    EventLoop* powerOfTwoChoices();
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "InetAddress.h"
+#include "NonCopyable.h"
+
+class Acceptor;
+class Channel;
+class EventLoop;
+class Socket;
+
+/**
+ * HotRestart: 零停机重启时旧进程一侧的监听fd交接
+ * 1. 旧进程在控制地址（Unix 域文件路径，创建后权限设为0600）上等待新进程连接；
+ *    只把fd交给与本进程有效uid相同的对端（SO_PEERCRED）。抽象命名空间不受文件权限保护，仅靠uid校验
+ * 2. 新进程连上后，旧进程关闭控制监听（以便新进程接着绑定同一地址），以 SCM_RIGHTS 发出全部监听fd
+ * 3. 新进程用这些fd构造 TcpServer 并 start()，此时两个进程共享同一监听队列，不会出现拒绝连接的窗口
+ * 4. 新进程回复确认后，旧进程调用 TakeoverCallback（通常为 TcpServer::drain）排空退出；
+ *    新进程未确认就断开时，旧进程继续服务并重新等待
+ * 仅在所属loop线程使用；需以 std::make_shared 创建
+ * 注意：kReusePortPerLoop 模式的per-loop监听套接字不参与交接，旧进程排空时其队列中的连接会被重置
+ */
+class HotRestart : NonCopyable, public std::enable_shared_from_this<HotRestart> {
+public:
+    using FdsProvider = std::function<std::vector<int>()>;  // 要交出的监听fd（如 TcpServer::listenFds），旧进程继续持有
+    using TakeoverCallback = std::function<void()>;
+
+    static constexpr size_t kMaxFds = 64;  // 单次交接的fd上限
+
+    HotRestart(EventLoop* loop, const InetAddress& controlAddr);
+    ~HotRestart();
+
+    void setFdsProvider(FdsProvider cb) { fdsProvider_ = std::move(cb); }
+    void setTakeoverCallback(TakeoverCallback cb) { takeoverCallback_ = std::move(cb); }
+
+    void start();  // 开始在控制地址上等待新进程
+    bool takenOver() const { return takenOver_; }
+
+    // ==== 新进程一侧（在事件循环启动前调用，阻塞）====
+
+    // 连接旧进程的控制地址并接收监听fd；没有旧进程（地址不存在或无人监听）或超时返回空
+    // timeoutSeconds 不足1毫秒（含0和负数）时按1毫秒处理，避免无限期阻塞
+    // 返回非空时须在 start() 接管的 TcpServer 之后调用 confirmTakeover，否则旧进程不会退出
+    static std::vector<int> receiveListenFds(const InetAddress& controlAddr, double timeoutSeconds, int* controlFd);
+    static void confirmTakeover(int controlFd);  // 通知旧进程排空并关闭控制连接
+
+    // fork+exec 方式：父进程导出监听fd到环境变量（同时清除 FD_CLOEXEC），子进程从中读取，格式 "3,4,5"
+    static bool exportListenFds(const std::vector<int>& fds, const std::string& envName);
+    static std::vector<int> listenFdsFromEnv(const std::string& envName);
+
+private:
+    // ==== 核心组件 ====
+    EventLoop* loop_;  // 所属事件循环（必须首位）
+    const InetAddress controlAddr_;
+    std::shared_ptr<Acceptor> acceptor_;  // 控制地址的监听，交接进行中为空
+    std::unique_ptr<Socket> peer_;  // 正在交接的新进程
+    std::unique_ptr<Channel> peerChannel_;
+
+    // ==== 运行时状态 ====
+    bool takenOver_;
+
+    // ==== 回调接口 ====
+    FdsProvider fdsProvider_;
+    TakeoverCallback takeoverCallback_;
+
+    // ==== 内部方法 ====
+    void listen();
+    void handleNewPeer(int sockfd);
+    void sendFds();
+    void handlePeerRead();
+    void closePeer();
+};
@@ -2,33 +2,59 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include <string>
 
-// 封装IPv4地址结构，方便操作IP和端口
+// 封装套接字地址：IPv4、IPv6 与 Unix 域（文件路径或Linux抽象命名空间），方便操作IP和端口
 class InetAddress {
 public:
-    // 通过字符串IP和数字端口构造，默认 127.0.0.1:0
+    // 通过字符串IP和数字端口构造，默认 127.0.0.1:0；ip 含 ':' 时按IPv6解析（如 "::1"、"::"）
     explicit InetAddress(std::string ip = "127.0.0.1", uint16_t port = 0);
 
-    // 直接通过sockaddr_in结构体构造
-    explicit InetAddress(const sockaddr_in& addr) : addr_(addr) {}
+    // 直接通过sockaddr_in/sockaddr_in6结构体构造
+    explicit InetAddress(const sockaddr_in& addr);
+    explicit InetAddress(const sockaddr_in6& addr);
+    // 通过内核返回的地址构造（accept、getsockname、recvmmsg 等），len 为内核回填的长度
+    InetAddress(const sockaddr* addr, socklen_t len) { setSockAddr(addr, len); }
 
-    // 获取IP字符串（如"192.168.1.1"）
+    // Unix 域地址：文件系统路径，或抽象命名空间名字（不含前导'\0'，不创建文件，最后一个fd关闭时自动释放）
+    static InetAddress unixPath(const std::string& path);
+    static InetAddress abstractUnix(const std::string& name);
+    // 解析 "ip:port"、"[ipv6]:port"、"unix:/path"、"unix:@name"，格式错误返回false
+    static bool parse(const std::string& spec, InetAddress* out);
+
+    sa_family_t family() const { return addr_.sa.sa_family; }
+    bool isIpv6() const { return family() == AF_INET6; }
+    bool isUnix() const { return family() == AF_UNIX; }
+    bool isAbstract() const;  // Unix 域抽象命名空间地址
+
+    // 获取IP字符串（如"192.168.1.1"、"::1"）；Unix 域返回路径（抽象地址以'@'开头），未命名的对端为空串
     std::string toIp() const;
 
-    // 获取IP:Port字符串（如"192.168.1.1:80"）
+    // 获取IP:Port字符串（如"192.168.1.1:80"、"[::1]:80"、"unix:/run/a.sock"、"unix:@name"）
     std::string toIpPort() const;
 
-    // 获取端口号（主机字节序）
+    // 获取端口号（主机字节序），Unix 域为0
     uint16_t toPort() const;
 
-    // 获取底层socket地址结构指针（用于系统调用）
-    const sockaddr_in* getSockAddr() const { return &addr_; }
+    // 获取底层socket地址结构指针与长度（用于系统调用）
+    const sockaddr* getSockAddr() const { return &addr_.sa; }
+    socklen_t getSockLen() const { return len_; }
 
     // 设置socket地址结构（用于accept等场景）
-    void setSockAddr(const sockaddr_in& addr) { addr_ = addr; }
+    void setSockAddr(const sockaddr* addr, socklen_t len);
+
+    bool operator==(const InetAddress& other) const;
 
 private:
-    sockaddr_in addr_;  // 实际存储的地址结构
+    // 按最大的 sockaddr_un 存储，避免 sockaddr_storage 的额外开销
+    union {
+        sockaddr sa;
+        sockaddr_in in;
+        sockaddr_in6 in6;
+        sockaddr_un un;
+    } addr_;
+    socklen_t len_;  // 有效长度：Unix 域地址为 offsetof(sun_path) + 路径长度
 };
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Poller.h"
+#include "Timestamp.h"
+
+// io_uring 就绪事件后端（不依赖 liburing，直接使用系统调用）：
+// 1. 每个 Channel 注册一个单次 POLL_ADD，事件处理完后重新挂上，语义与 epoll LT 一致
+//    （multishot poll 只在新的唤醒时上报，相当于ET，会让一次只读一段的Channel丢事件）
+// 2. updateChannel/removeChannel 以及重新挂载只把 SQE 写入提交队列，
+//    在下一次 poll() 中与等待动作合并为一次 io_uring_enter
+// 3. 可选 SQPOLL：由内核线程轮询提交队列，进一步减少系统调用
+class Channel;
+class IoUringPoller : public Poller {
+public:
+    IoUringPoller(EventLoop* loop, bool sqpoll);
+    ~IoUringPoller() override;
+
+    // 初始化失败（内核不支持或被禁用）时为false，由工厂回退到epoll
+    bool valid() const { return ringFd_ >= 0; }
+
+    MonoTimestamp poll(int timeoutMs, ChannelList* activeChannels) override;
+    void updateChannel(Channel* channel) override;
+    void removeChannel(Channel* channel) override;
+
+private:
+    // 每个fd的注册状态；generation 编码进 user_data，用于丢弃已注销请求的迟到CQE
+    struct PollState {
+        Channel* channel = nullptr;
+        uint32_t generation = 0;  // 当前 POLL_ADD 请求的代号
+        uint32_t events = 0;  // 关注的事件掩码（0表示不再关注，不会被重新挂载）
+        bool armed = false;  // 是否存在生效中的 POLL_ADD
+        uint64_t round = 0;  // 最近一次被收集为就绪的 poll 轮次（同一轮多个CQE合并）
+        uint32_t revents = 0;  // 本轮累计的就绪事件
+    };
+
+    // ==== 环形队列（mmap映射）====
+    int ringFd_;  // io_uring 实例的文件描述符
+    bool sqpoll_;  // 是否启用 SQPOLL
+    void* sqRing_;
+    size_t sqRingSize_;
+    void* cqRing_;
+    size_t cqRingSize_;
+    io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqFlags_;
+    unsigned* sqArray_;
+    unsigned sqEntries_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    io_uring_cqe* cqes_;
+
+    // ==== 注册状态 ====
+    unsigned pendingSubmits_;  // 已写入SQ但尚未提交的SQE数量
+    uint32_t nextGeneration_;  // 全局递增的请求代号
+    uint64_t round_;  // poll 轮次
+    std::vector<PollState> states_;  // 以fd为下标
+    std::vector<int> readyFds_;  // 上一轮就绪的fd（下一轮 poll 前需要重新挂载）
+    std::vector<int> retryFds_;  // SQ 满时未能挂载的fd（下一轮 poll 前重试）
+
+    // ==== 常量配置 ====
+    static const unsigned kRingEntries = 1024;  // 提交队列大小，完成队列为其4倍
+    static const uint64_t kInternalUserData = UINT64_MAX;  // 内部请求（POLL_REMOVE）的完成事件，直接忽略
+
+    // ==== 内部方法 ====
+    bool setupRing(bool sqpoll);
+    io_uring_sqe* getSqe();  // 获取空闲SQE（尚未发布），队列满时先提交
+    void commitSqe();  // 填好 getSqe 返回的SQE后发布给内核
+    int submitAndWait(unsigned waitNr, int timeoutMs);
+    PollState* findState(int fd);  // 未注册时返回nullptr
+    void queuePollAdd(int fd, PollState& state);
+    void queuePollRemove(int fd, const PollState& state);
+    static uint64_t makeUserData(int fd, uint32_t generation) { return (static_cast<uint64_t>(static_cast<uint32_t>(fd)) << 32) | generation; }
+    void rearmReadyChannels();  // 重新挂载上一轮已触发的单次 POLL_ADD 及 SQ 满时挂载失败的fd
+    void fillActiveChannels(ChannelList* activeChannels);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "NonCopyable.h"
+
+/**
+ * LoopStats: 单个 EventLoop 运行统计的快照（可按值复制、累加）
+ * - 每次 poll 返回计为一轮：轮数、活跃Channel数
+ * - 耗时按阶段拆分：poll内（阻塞+自旋）、IO事件回调、跨线程回调
+ * - 跨线程回调队列：每轮执行的回调数（即本轮开始时的队列深度，受单轮上限截断）
+ * - loop lag：定时器到期时间与实际执行时间之差的直方图，反映loop被回调阻塞的程度
+ */
+struct LoopStats {
+    // 第0桶 [0, 2)us，第i桶 [2^i, 2^(i+1))us，最后一桶收纳所有更大的值（约>1s）
+    static constexpr size_t kLagBuckets = 21;
+
+    uint64_t polls = 0;  // poll返回次数
+    uint64_t activeChannels = 0;  // 累计活跃Channel数
+    uint64_t maxActiveChannels = 0;  // 单轮最多活跃Channel数
+    int64_t pollMicros = 0;  // 在poll中的时长
+    int64_t handlerMicros = 0;  // 执行IO事件回调的时长
+    int64_t functorMicros = 0;  // 执行跨线程回调的时长
+    uint64_t functors = 0;  // 已执行的跨线程回调数
+    uint64_t functorBatches = 0;  // 执行过回调的轮数
+    uint64_t maxFunctorBatch = 0;  // 单轮最多执行的回调数
+    uint64_t deferredBatches = 0;  // 队列未清空、剩余回调留到下一轮的次数
+    uint64_t timersFired = 0;  // 已执行的定时器数
+    int64_t maxLagMicros = 0;  // 最大定时器延迟
+    std::array<uint64_t, kLagBuckets> lagHistogram{};  // 定时器延迟分布
+
+    LoopStats& operator+=(const LoopStats& other);  // 多个loop汇总：计数相加，最大值取最大
+
+    double avgActiveChannels() const;  // 每轮平均活跃Channel数
+    double avgFunctorBatch() const;  // 每轮平均回调数（只计执行过回调的轮）
+    double busyRatio() const;  // 回调耗时占总时长的比例，接近1说明loop已饱和
+    int64_t lagPercentile(double p) const;  // 定时器延迟的p分位（0~1），返回所在桶的上界（微秒）
+
+    static size_t lagBucket(int64_t micros);  // 延迟所属的桶
+    static int64_t lagBucketUpperBound(size_t bucket);  // 桶的上界（微秒，不含）
+};
+
+/**
+ * LoopStatsRecorder: EventLoop 内部的统计计数器
+ * 只由所属loop线程写入（relaxed load+store，无原子读改写），任意线程可调用 snapshot() 读取
+ */
+class LoopStatsRecorder : NonCopyable {
+public:
+    LoopStatsRecorder() = default;
+
+    // ==== 以下仅在loop线程调用 ====
+    void recordPoll(size_t activeChannels, int64_t pollMicros);
+    void recordHandlers(int64_t micros) { add(handlerMicros_, micros); }
+    void recordFunctors(size_t count, int64_t micros, bool deferred);
+    void recordTimerLag(int64_t micros);
+
+    LoopStats snapshot() const;  // 任意线程
+
+private:
+    template <typename T>
+    static void add(std::atomic<T>& counter, T n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    template <typename T>
+    static void max(std::atomic<T>& counter, T n) {
+        if (n > counter.load(std::memory_order_relaxed)) {
+            counter.store(n, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> polls_{0};
+    std::atomic<uint64_t> activeChannels_{0};
+    std::atomic<uint64_t> maxActiveChannels_{0};
+    std::atomic<int64_t> pollMicros_{0};
+    std::atomic<int64_t> handlerMicros_{0};
+    std::atomic<int64_t> functorMicros_{0};
+    std::atomic<uint64_t> functors_{0};
+    std::atomic<uint64_t> functorBatches_{0};
+    std::atomic<uint64_t> maxFunctorBatch_{0};
+    std::atomic<uint64_t> deferredBatches_{0};
+    std::atomic<uint64_t> timersFired_{0};
+    std::atomic<int64_t> maxLagMicros_{0};
+    std::array<std::atomic<uint64_t>, LoopStats::kLagBuckets> lagHistogram_{};
+};
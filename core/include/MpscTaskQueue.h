@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "NonCopyable.h"
+
+/**
+ * MpscTaskQueue: 无锁多生产者单消费者任务队列（Vyukov MPSC）
+ * 用于 EventLoop 跨线程投递回调，替代 mutex + vector
+ *
+ * - push: 任意线程调用，一次原子 exchange，无锁
+ * - 节点取自队列自带的固定节点池（带版本号的无锁空闲栈，防ABA），池耗尽时才退回 new/delete；
+ *   Task 本身是 std::function，捕获超出其内联存储的回调仍会各自分配
+ * - beginBatch/pop: 仅消费者（loop线程）调用
+ * - 生产者在 exchange 与链接 next 之间被打断时，消费者会暂时看不到其后的节点，
+ *   该生产者完成链接后自行负责唤醒消费者
+ */
+class MpscTaskQueue : NonCopyable {
+public:
+    using Task = std::function<void()>;
+
+    MpscTaskQueue();
+    ~MpscTaskQueue();
+
+    // 入队（任意线程）
+    void push(Task&& task);
+
+    // 开启一轮消费：记录当前队尾，本轮 pop 只取此前已入队的任务（仅消费者线程）
+    void beginBatch() { batchEnd_ = head_.load(std::memory_order_acquire); }
+    // 出队：本轮已取完、队列为空或尾部尚未链接完成时返回 false（仅消费者线程）
+    bool pop(Task* task);
+    // 是否还有未消费的任务（仅消费者线程）
+    bool hasPending() const { return head_.load(std::memory_order_acquire) != tail_; }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        Task task;
+        std::atomic<uint32_t> freeNext{0};  // 空闲栈中的后继（池下标+1，0表示栈底）
+    };
+
+    static constexpr uint32_t kPoolSize = 1024;  // 与 EventLoop 单轮回调上限一致，稳态下不再分配节点
+
+    Node* allocNode();  // 任意线程
+    void freeNode(Node* node);  // 仅消费者线程
+    bool fromPool(const Node* node) const;
+
+    // ==== 节点池 ====
+    const std::unique_ptr<Node[]> pool_;
+    alignas(64) std::atomic<uint64_t> freeTop_;  // 高32位为版本号，低32位为栈顶下标+1
+
+    // ==== 生产者端 ====
+    alignas(64) std::atomic<Node*> head_;  // 最新入队的节点
+
+    // ==== 消费者端 ====
+    alignas(64) Node* tail_;  // 哨兵节点（已被消费的最后一个节点）
+    Node* batchEnd_;  // 本轮消费的终点
+};
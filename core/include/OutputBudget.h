@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "NonCopyable.h"
+
+/**
+ * OutputBudget: 跨连接共享的输出内存预算（由 TcpServer 持有，各 loop 线程并发更新）
+ * 各连接把输出链中占用内存的字节数计入 used；超出 limit 时，有积压输出的连接暂停读取
+ */
+class OutputBudget : NonCopyable {
+public:
+    explicit OutputBudget(size_t limitBytes) : limit_(limitBytes), used_(0) {}
+
+    void add(size_t n) { used_.fetch_add(n, std::memory_order_relaxed); }
+    void sub(size_t n) { used_.fetch_sub(n, std::memory_order_relaxed); }
+
+    size_t used() const { return used_.load(std::memory_order_relaxed); }
+    size_t limit() const { return limit_; }
+    bool exceeded() const { return used() > limit_; }
+
+private:
+    const size_t limit_;
+    std::atomic<size_t> used_;
+};
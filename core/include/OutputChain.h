@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BufferSlice.h"
+#include "NonCopyable.h"
+
+/**
+ * OutputChain: 连接的输出队列，由若干段按顺序组成
+ * - 自有字节段：send 拷贝进来的数据，连续追加时合并到尾段
+ * - 共享段：引用计数的只读片段（BufferSlice），不拷贝
+ * - 文件段：(fd, offset, len) 文件区间，使用 sendfile 发送，fd 由调用方保持打开
+ *
+ * writeTo 严格按入队顺序写出：相邻的内存段合并为一次 writev，文件段单独 sendfile
+ * 启用 MSG_ZEROCOPY 后，不小于阈值的共享段单独以零拷贝方式发送，其引用保留到内核完成通知
+ * 仅在所属 loop 线程中使用
+ */
+class OutputChain : NonCopyable {
+public:
+    // 零拷贝发送统计
+    struct ZeroCopyStats {
+        uint64_t sends = 0;  // 以 MSG_ZEROCOPY 发出的调用次数
+        uint64_t completions = 0;  // 内核已确认完成的调用次数
+        uint64_t copied = 0;  // 完成通知表明内核实际做了拷贝的次数（如回环、网卡不支持SG）
+        uint64_t fallbacks = 0;  // 因 ENOBUFS（锁页额度不足）改走普通拷贝发送的次数
+    };
+
+    OutputChain() = default;
+
+    // 追加拷贝数据
+    void append(const void* data, size_t len);
+    // 追加共享只读片段（不拷贝），该段写完即释放对片段的引用
+    void append(const BufferSlice& slice);
+    // 追加文件区间
+    void appendFile(int fd, off_t offset, size_t len);
+
+    size_t readableBytes() const { return bytes_; }  // 尚未写出的总字节数（含文件段）
+    size_t memoryBytes() const { return bytes_ - fileBytes_; }  // 其中占用内存的部分（自有段与共享段）
+    bool empty() const { return segments_.empty(); }
+    size_t segmentCount() const { return segments_.size(); }
+
+    // 按顺序写出，最多 maxBytes 字节，遇到短写或出错即停止
+    // 返回本次写出的字节数；最后一次系统调用失败时 *saveErrno 为其 errno（含 EAGAIN），否则为 0
+    size_t writeTo(int fd, size_t maxBytes, int* saveErrno);
+
+    // 丢弃全部未写出数据（等待零拷贝完成的引用不受影响）
+    void clear();
+
+    // 零拷贝阈值：0 表示关闭，套接字需已设置 SO_ZEROCOPY
+    void setZeroCopyThreshold(size_t threshold) { zeroCopyThreshold_ = threshold; }
+    size_t zeroCopyThreshold() const { return zeroCopyThreshold_; }
+    // 从套接字错误队列读取零拷贝完成通知并释放对应片段，返回处理的通知条数
+    size_t reapZeroCopyCompletions(int fd);
+    bool hasZeroCopyPending() const { return !zeroCopyPending_.empty(); }
+    // 取出尚未收到完成通知的数据持有者（连接关闭时须保活到套接字关闭之后）
+    std::vector<std::shared_ptr<const void>> takeZeroCopyOwners();
+    const ZeroCopyStats& zeroCopyStats() const { return zeroCopyStats_; }
+
+private:
+    enum SegmentType { kOwned, kShared, kFile };
+
+    struct Segment {
+        SegmentType type = kOwned;
+        std::string owned{};  // kOwned：数据存放处
+        size_t pos = 0;  // kOwned：已写出的前缀长度
+        std::shared_ptr<const void> owner{};  // kShared：保活句柄
+        const char* data = nullptr;  // kShared：当前写位置
+        int fd = -1;  // kFile
+        off_t offset = 0;  // kFile：当前文件偏移
+        size_t len = 0;  // 剩余字节数
+    };
+
+    // 等待内核完成通知的零拷贝发送：id 为套接字上零拷贝调用的序号
+    struct ZeroCopyPending {
+        uint32_t id;
+        std::shared_ptr<const void> owner;
+    };
+
+    static const char* peek(const Segment& seg) { return seg.type == kOwned ? seg.owned.data() + seg.pos : seg.data; }
+    bool zeroCopyEligible(const Segment& seg) const { return zeroCopyThreshold_ > 0 && seg.type == kShared && seg.len >= zeroCopyThreshold_; }
+
+    // 以下两者返回写出的字节数，*want 为本次期望写出的字节数
+    size_t writeMemory(int fd, size_t maxBytes, size_t* want, int* saveErrno);  // 从队头起合并内存段 writev
+    size_t writeFile(int fd, size_t maxBytes, size_t* want, int* saveErrno);  // 队头文件段 sendfile
+    size_t writeZeroCopy(int fd, size_t maxBytes, size_t* want, int* saveErrno);  // 队头共享段 MSG_ZEROCOPY
+    void consume(size_t n);  // 从队头移除已写出的内存字节
+
+    static constexpr size_t kMaxIov = 64;  // 单次 writev 的最大段数
+    static constexpr size_t kCompactThreshold = 64 * 1024;  // 自有尾段已写前缀超过该值时回收
+
+    std::deque<Segment> segments_;
+    size_t bytes_ = 0;
+    size_t fileBytes_ = 0;
+
+    size_t zeroCopyThreshold_ = 0;
+    uint32_t nextZeroCopyId_ = 0;  // 与内核的计数保持一致：每次成功的零拷贝调用加一
+    std::deque<ZeroCopyPending> zeroCopyPending_;
+    ZeroCopyStats zeroCopyStats_;
+};
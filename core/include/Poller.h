@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 #include "NonCopyable.h"
@@ -19,18 +19,28 @@ public:
     virtual ~Poller() = default;
 
     // 给所有IO复用保留统一的接口，定义为纯虚函数强制要求派生类实现功能
-    virtual Timestamp poll(int timeoutMs, ChannelList* activeChannels) = 0;
+    virtual MonoTimestamp poll(int timeoutMs, ChannelList* activeChannels) = 0;  // 返回poll返回时的单调时间
     virtual void updateChannel(Channel* channel) = 0;
     virtual void removeChannel(Channel* channel) = 0;
 
     // 判断参数channel是否在当前的Poller当中
     bool hasChannel(Channel* channel) const;
+    // 后端是否支持边缘触发（Channel::setEdgeTriggered）
+    virtual bool supportsEdgeTriggered() const { return false; }
 
     // EventLoop可以通过该接口获取默认的IO复用的具体实现
     static Poller* newDefaultPoller(EventLoop* loop);
 
 protected:
-    // map的kv值: key:sockfd value:sockfd所属的channel通道类型
-    using ChannelMap = std::unordered_map<int, Channel*>;
-    ChannelMap channels_;
+    // 以fd为下标的稠密表：fd由内核按最小可用分配，天然紧凑，查找无需哈希
+    struct ChannelSlot {
+        Channel* channel = nullptr;  // fd所属的channel通道
+        uint32_t registeredEvents = 0;  // 当前已注册到内核的事件掩码（用于跳过冗余的epoll_ctl）
+    };
+    using ChannelTable = std::vector<ChannelSlot>;
+
+    // 取fd对应的槽位，必要时按倍数扩容
+    ChannelSlot& slotOf(int fd);
+
+    ChannelTable channels_;
 };
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
+#include "InetAddress.h"
 #include "NonCopyable.h"
+#include "SocketOptions.h"
 
-class InetAddress;
 // 封装socket fd
 class Socket : NonCopyable {
 public:
@@ -10,7 +11,7 @@ public:
 
     int getSocketFd() const { return this->sockfd_; }
     void bindAddress(const InetAddress& local_addr);
-    void listen();
+    void listen(int backlog = SocketOptions().backlog);
     int accept(InetAddress* peer_addr);
     void shutdownWrite();
 
@@ -18,6 +19,28 @@ public:
     void setReuseAddr(bool on);  // 地址重用
     void setReusePort(bool on);  // 端口重用（负载均衡）
     void setKeepAlive(bool on);  // 心跳检测，设职长连接
+    void setBusyPoll(int micros);  // SO_BUSY_POLL：阻塞读时在驱动队列上忙轮询的微秒数
+    bool setZeroCopy(bool on);  // SO_ZEROCOPY：允许 send 使用 MSG_ZEROCOPY
+    void setLinger(bool on, int seconds);  // SO_LINGER：{on, 0} 时 close 发RST并丢弃发送队列
+    void setIncomingCpu(int cpu);  // SO_INCOMING_CPU：优先接收该CPU上软中断处理的连接
+    bool attachReusePortCpuSteering(unsigned groupSize);  // reuseport组内按 CPU % groupSize 选择监听套接字
+    void setRecvBuffer(int bytes);  // SO_RCVBUF
+    void setSendBuffer(int bytes);  // SO_SNDBUF
+    void setFastOpen(int queueLen);  // TCP_FASTOPEN（监听套接字）
+    void setDeferAccept(int seconds);  // TCP_DEFER_ACCEPT（监听套接字）
+    void setNotSentLowat(int bytes);  // TCP_NOTSENT_LOWAT
+    void setUserTimeout(int millis);  // TCP_USER_TIMEOUT
+    void setKeepAliveProbes(int idleSeconds, int intervalSeconds, int count);  // TCP_KEEPIDLE/KEEPINTVL/KEEPCNT，0表示不修改
+
+    // 按 SocketOptions 批量设置，tcp 为 false（Unix 域）时跳过TCP专有选项
+    void applyListenOptions(const SocketOptions& opts, bool tcp);  // listen() 之前调用
+    void applyConnectionOptions(const SocketOptions& opts, bool tcp);  // accept 之后调用
+
+    // ==== 不持有fd的工具函数 ====
+    static InetAddress getLocalAddr(int sockfd);  // getsockname
+    static InetAddress getPeerAddr(int sockfd);  // getpeername
+    static int getSocketError(int sockfd);  // 读取并清除 SO_ERROR
+    static bool isSelfConnect(int sockfd);  // 本地端口与目标端口相同的自连接（连接本机临时端口时可能发生）
 
 private:
     const int sockfd_;
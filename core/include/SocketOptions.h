@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * SocketOptions: TcpServer 监听套接字与新连接的套接字选项（0 表示保持内核默认）
+ * - 监听套接字：listen() 之前设置一次；TCP的收发缓冲区也在此设置，由accept出的连接继承
+ *   （TCP窗口缩放因子在握手时确定，连接建立后再调大接收缓冲区无法扩大窗口；Unix 域连接不继承，accept 后另行设置）
+ * - 新连接：accept 后、建立 TcpConnection 时设置一次
+ * TCP专有选项对 Unix 域地址跳过
+ */
+struct SocketOptions {
+    // ==== 监听套接字 ====
+    int backlog = 1024;  // listen 全连接队列长度（受 net.core.somaxconn 限制）
+    int fastOpenQueue = 0;  // TCP_FASTOPEN：等待完成握手的TFO请求上限，SYN中的数据省去一个RTT（需 net.ipv4.tcp_fastopen 开启服务端）
+    int deferAcceptSeconds = 0;  // TCP_DEFER_ACCEPT：握手完成后等待首个数据段的秒数，期间不唤醒acceptor
+    int recvBufferBytes = 0;  // SO_RCVBUF，设置后关闭该连接的接收缓冲区自动调节
+    int sendBufferBytes = 0;  // SO_SNDBUF，设置后关闭该连接的发送缓冲区自动调节
+
+    // ==== 新连接 ====
+    bool tcpNoDelay = true;  // TCP_NODELAY：关闭Nagle，避免小响应与延迟ACK叠加的数十毫秒停顿
+    int notSentLowatBytes = 0;  // TCP_NOTSENT_LOWAT：内核中未发送数据低于该值才报告可写，减少发送缓冲区排队
+    int userTimeoutMillis = 0;  // TCP_USER_TIMEOUT：已发数据超过该时长未被确认即断开连接
+    bool keepAlive = true;  // SO_KEEPALIVE
+    int keepIdleSeconds = 0;  // TCP_KEEPIDLE：空闲多久后开始探测
+    int keepIntervalSeconds = 0;  // TCP_KEEPINTVL：探测间隔
+    int keepCount = 0;  // TCP_KEEPCNT：无响应多少次后断开
+};
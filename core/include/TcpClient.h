@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Callbacks.h"
+#include "InetAddress.h"
+#include "NonCopyable.h"
+#include "TcpConnection.h"
+
+class Connector;
+class EventLoop;
+
+/**
+ * TcpClient: 非阻塞的主动连接客户端，连接建立后与服务端连接一样由 TcpConnection 承载
+ * 连接、重连、超时都在所属 loop 中完成，不会阻塞IO线程，用于构建 Redis / HTTP / RPC 等 loop 原生客户端
+ */
+class TcpClient : NonCopyable {
+public:
+    TcpClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& nameArg);
+    ~TcpClient();  // 需在所属loop线程析构
+
+    void connect();  // 开始连接（任意线程）
+    void disconnect();  // 关闭已建立连接的写端（任意线程）
+    void stop();  // 停止尚未完成的连接与重试（任意线程）
+
+    TcpConnectionPtr connection() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return connection_;
+    }
+
+    EventLoop* getLoop() const { return loop_; }
+    const std::string& name() const { return name_; }
+
+    // 已建立的连接断开后自动重连（退避从初始值重新开始）
+    void enableRetry() { retry_ = true; }
+    bool retry() const { return retry_; }
+
+    // 连接参数，需在 connect() 之前设置
+    void setConnectTimeout(double seconds);  // 单次连接超时，超时后按退避重试
+    void setRetryDelay(double initialSeconds, double maxSeconds);  // 退避的初始值与上限（带随机抖动）
+    void setMaxAttempts(int n);  // 连续失败的最大尝试次数，0 表示无限重试
+
+    void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+    void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
+    void setWriteCompleteCallback(WriteCompleteCallback cb) { writeCompleteCallback_ = std::move(cb); }
+    void setConnectFailedCallback(std::function<void()> cb);  // 用尽尝试次数仍未连上
+
+private:
+    void newConnection(int sockfd);
+    void removeConnection(const TcpConnectionPtr& conn);
+
+    EventLoop* loop_;
+    std::shared_ptr<Connector> connector_;
+    const std::string name_;
+    const std::shared_ptr<const std::string> connNamePrefix_;  // 各次连接共享的连接名前缀
+    ConnectionCallback connectionCallback_;
+    MessageCallback messageCallback_;
+    WriteCompleteCallback writeCompleteCallback_;
+    std::atomic_bool retry_;  // 断线后是否重连
+    std::atomic_bool connect_;  // 是否处于连接意图中（stop/disconnect 后为 false）
+    uint64_t nextConnId_;  // 仅在loop线程中使用
+    mutable std::mutex mutex_;
+    TcpConnectionPtr connection_;  // 由 mutex_ 保护
+};
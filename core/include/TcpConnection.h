@@ -1,19 +1,26 @@
 #pragma once
 
+#include <stdint.h>
+
 #include <any>
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Buffer.h"
+#include "BufferSlice.h"
 #include "Callbacks.h"
+#include "Channel.h"
 #include "EventLoop.h"
 #include "InetAddress.h"
 #include "NonCopyable.h"
+#include "OutputBudget.h"
+#include "OutputChain.h"
+#include "Socket.h"
+#include "TimingWheel.h"
 #include "Timestamp.h"
 
-class Channel;
-class Socket;
 
 /**
  * TcpConnection: 表示一次TCP连接（主动或被动）
@@ -22,11 +29,13 @@ class Socket;
  */
 class TcpConnection : NonCopyable, public std::enable_shared_from_this<TcpConnection> {
 public:
-    TcpConnection(EventLoop* loop, const std::string& nameArg, int sockfd, const InetAddress& localAddr, const InetAddress& peerAddr);
+    // namePrefix 由同一服务/客户端的所有连接共享，连接名 "前缀#id" 仅在需要时才格式化
+    TcpConnection(EventLoop* loop, uint64_t id, std::shared_ptr<const std::string> namePrefix, int sockfd, const InetAddress& localAddr, const InetAddress& peerAddr);
     ~TcpConnection();
 
     EventLoop* getLoop() const { return loop_; }
-    const std::string& name() const { return name_; }
+    uint64_t id() const { return id_; }  // 在所属 TcpServer/TcpClient 内唯一
+    std::string name() const { return *namePrefix_ + '#' + std::to_string(id_); }
     const InetAddress& localAddress() const { return localAddr_; }
     const InetAddress& peerAddress() const { return peerAddr_; }
 
@@ -35,13 +44,21 @@ public:
 
     // ========== 数据发送接口 ==========
     void send(const std::string& buf);
+    void send(std::string&& buf);  // 接管字符串：未发完的部分直接入链，不再拷贝
     void send(const void* data, size_t len);
     void send(Buffer* buf);  // 对齐 HttpServer.cpp 中的调用
 
+    // 零拷贝发送：多个只读片段按顺序合并为一次 writev，未写出的部分只持有引用，内核接收后即释放
+    void send(const BufferSlice& slice);
+    void send(std::vector<BufferSlice> slices);
+
+    // 文件区间与内存数据在同一输出链中按调用顺序发送；fd 需保持打开直到 writeComplete 回调
     void sendFile(int fileDescriptor, off_t offset, size_t count);
 
     // 关闭写端（半关闭）
     void shutdown();
+    // 立即关闭连接，丢弃未发送的数据（如客户端销毁、连接池淘汰）
+    void forceClose();
 
     // ========== 回调注册接口 ==========
     void setConnectionCallback(const ConnectionCallback& cb) { connectionCallback_ = cb; }
@@ -53,6 +70,43 @@ public:
         highWaterMark_ = highWaterMark;
     }
 
+    // ========== 超时控制（由 TcpServer 在连接建立前设置，<=0 表示不启用）==========
+    void setIdleTimeout(double seconds) { idleTimeout_ = seconds; }  // 无读写活动超时
+    void setReadTimeout(double seconds) { readTimeout_ = seconds; }  // 读截止超时（如 HTTP 头部读取）
+    void setWriteStallTimeout(double seconds) { writeStallTimeout_ = seconds; }  // 输出积压但无写进展超时
+
+    // 边缘触发模式：读写都循环到EAGAIN，单次事件最多处理 ioBudget 字节，剩余部分让出给其他连接后继续
+    // 由 TcpServer 在 connectEstablished 之前设置
+    void setEdgeTriggered(bool on, size_t ioBudget) {
+        edgeTriggered_ = on;
+        ioBudget_ = ioBudget;
+    }
+
+    // ========== 读流控 ==========
+    // 暂停/恢复读取（任意线程）：暂停期间不关注EPOLLIN，数据留在内核接收缓冲，由TCP窗口反压对端
+    void startRead();
+    void stopRead();
+    bool isReading() const { return reading_; }  // 使用方的读意图（不含自动反压）
+
+    // 输出积压时自动暂停读取：输出链内存达到 highMark，或共享预算超限且本连接积压超过 lowMark 时暂停，
+    // 降到 lowMark 及以下后恢复；highMark 为 0 时仅按预算判断。由 TcpServer 在 connectEstablished 之前设置
+    void setOutputBackpressure(size_t highMark, size_t lowMark, std::shared_ptr<OutputBudget> budget);
+
+    // 新连接的套接字选项（NODELAY、keepalive等），在 connectEstablished 之前设置一次；Unix 域连接跳过TCP专有选项
+    void applySocketOptions(const SocketOptions& opts) { socket_.applyConnectionOptions(opts, !localAddr_.isUnix()); }
+
+    // SO_BUSY_POLL（微秒），低延迟场景以CPU换取接收延迟
+    void setBusyPoll(int micros);
+
+    // MSG_ZEROCOPY：不小于 threshold 字节的 BufferSlice 以零拷贝发送，片段保留到内核完成通知，0 表示关闭
+    // 由 TcpServer 在 connectEstablished 之前设置；统计信息仅限loop线程读取
+    void setZeroCopy(size_t threshold);
+    const OutputChain::ZeroCopyStats& zeroCopyStats() const { return outputChain_.zeroCopyStats(); }
+
+    // 读截止计时：协议层开始等待一个完整请求时启动（已启动则不延长），读完后取消（仅限loop线程）
+    void startReadTimeout();
+    void cancelReadTimeout();
+
     // ========== 生命周期接口 ==========
     void connectEstablished();  // 由 TcpServer 在新连接 accept 后调用
     void connectDestroyed();  // 由 TcpServer 在连接关闭时调用
@@ -63,6 +117,8 @@ public:
     std::any& getMutableContext() { return context_; }
     void clearContext() { context_.reset(); }
 
+    Buffer* inputBuffer() { return &inputBuffer_; }  // 尚未被消息回调取走的输入（仅在loop线程中访问）
+
 private:
     enum StateE {
         kDisconnected,  // 已断开
@@ -79,34 +135,76 @@ private:
     void handleClose();
     void handleError();
 
+    void handleReadEdgeTriggered(Timestamp receiveTime);
+
+    void startReadInLoop();
+    void stopReadInLoop();
+    void updateReadInterest();  // 按 reading_ 与 backpressured_ 同步EPOLLIN关注
+    void updateOutputBackpressure();  // 输出链大小变化后：更新预算计数，判断是否暂停/恢复读取
+
+    // ET模式下EPOLLOUT常驻注册，写意图只记在 writing_ 中，避免反复 epoll_ctl(MOD)
+    bool isWriting() const;
+    void enableWriting();
+    void disableWriting();
+
     // ========== 内部执行函数 ==========
     void sendInLoop(const void* data, size_t len);
+    void sendSlicesInLoop(const BufferSlice* slices, size_t count);
     void sendFileInLoop(int fileDescriptor, off_t offset, size_t count);
     void shutdownInLoop();
+    void forceCloseInLoop();
+    void queueWriteComplete();  // 输出链清空时通知上层
+    void onOutputQueued(size_t oldLen);  // 数据入链后：高水位检查、关注写事件、启动写停滞计时
+
+    // ========== 超时处理 ==========
+    void handleTimeout(const char* reason);  // 超时强制关闭，复用 handleClose 路径
+    void armWriteStallTimeout();  // 输出开始积压时启动写停滞计时
+    void onWriteProgress();  // 有数据写出：推迟空闲与写停滞截止时间
+    void cancelTimeouts();  // 摘除全部时间轮条目
 
 private:
     EventLoop* loop_;  // 所属事件循环（线程）
     std::atomic_int state_;  // 状态机
     bool reading_;  // 是否监听读事件
+    bool edgeTriggered_;  // 是否使用边缘触发
+    bool writing_;  // ET模式下是否有待写数据
+    size_t ioBudget_;  // ET模式下单次事件的读写字节预算
 
-    std::unique_ptr<Socket> socket_;  // 封装的 socket
-    std::unique_ptr<Channel> channel_;  // 绑定事件通道
+    // Socket/Channel 内嵌而非单独堆分配：连接经 allocate_shared 从loop的内存池取一个块即可容纳全部状态
+    Socket socket_;  // 封装的 socket（声明在 channel_ 之前，析构时后于 channel_ 关闭fd）
+    Channel channel_;  // 绑定事件通道
 
-    const std::string name_;  // 连接名
+    const uint64_t id_;  // 连接ID
+    const std::shared_ptr<const std::string> namePrefix_;  // 连接名前缀（共享）
     const InetAddress localAddr_;  // 本地地址
     const InetAddress peerAddr_;  // 对端地址
 
     Buffer inputBuffer_;  // 输入缓冲
-    Buffer outputBuffer_;  // 输出缓冲
+    OutputChain outputChain_;  // 输出链（内存段 + 文件段）
 
     size_t highWaterMark_;  // 高水位阈值
     HighWaterMarkCallback highWaterMarkCallback_;
 
+    // 输出积压读反压（仅在loop线程中访问）
+    bool backpressured_;  // 是否因输出积压暂停了读取
+    size_t backpressureHigh_;
+    size_t backpressureLow_;
+    std::shared_ptr<OutputBudget> outputBudget_;  // 跨连接共享的输出内存预算（可为空）
+    size_t accountedBytes_;  // 已计入 outputBudget_ 的字节数
+
     ConnectionCallback connectionCallback_;
     MessageCallback messageCallback_;
     WriteCompleteCallback writeCompleteCallback_;
     CloseCallback closeCallback_;
 
+    // 超时控制（时间轮条目嵌入连接对象，仅在loop线程中操作）
+    double idleTimeout_;
+    double readTimeout_;
+    double writeStallTimeout_;
+    TimingWheel::Entry idleEntry_;
+    TimingWheel::Entry readEntry_;
+    TimingWheel::Entry writeStallEntry_;
+
     // 任意类型上下文，支持 TLSConnection / HttpContext / 用户对象
     std::any context_;
 };
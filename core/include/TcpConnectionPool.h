@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Callbacks.h"
+#include "InetAddress.h"
+#include "NonCopyable.h"
+#include "TimerId.h"
+#include "Timestamp.h"
+
+class Connector;
+class EventLoop;
+
+/**
+ * TcpConnectionPool: 单个 EventLoop 内按上游地址复用连接的连接池
+ * - 每个 loop 各持有一个池，全部方法仅在该 loop 线程调用，无需加锁
+ * - acquire 优先复用空闲连接（LIFO，最近归还的连接最可能仍然有效），否则非阻塞建连
+ * - release 归还连接；超过每个上游的空闲上限或空闲超时的连接被关闭
+ * - 空闲期间被对端关闭的连接自动从池中移除
+ * 借出期间连接的消息回调由使用方设置，归还后（本轮回调结束时）恢复为丢弃数据
+ */
+class TcpConnectionPool : NonCopyable {
+public:
+    using AcquireCallback = std::function<void(const TcpConnectionPtr&)>;  // 建连失败时参数为空
+
+    TcpConnectionPool(EventLoop* loop, const std::string& nameArg);
+    ~TcpConnectionPool();  // 需在所属loop线程析构，会关闭池中所有连接
+
+    // 以下配置需在首次 acquire 之前设置
+    void setMaxIdlePerKey(size_t n) { maxIdlePerKey_ = n; }
+    void setIdleTimeout(double seconds);  // <=0 表示空闲连接不过期
+    void setConnectTimeout(double seconds) { connectTimeout_ = seconds; }
+    void setRetryDelay(double initialSeconds, double maxSeconds) {
+        initRetryDelay_ = initialSeconds;
+        maxRetryDelay_ = maxSeconds;
+    }
+    void setMaxAttempts(int n) { maxAttempts_ = n > 0 ? n : 1; }  // 单次 acquire 的建连尝试次数
+
+    void acquire(const InetAddress& addr, AcquireCallback cb);
+    void release(const TcpConnectionPtr& conn);
+
+    size_t idleCount() const;
+    size_t liveCount() const { return live_.size(); }  // 已建立的连接数（含空闲与借出）
+    size_t pendingCount() const { return pending_.size(); }  // 正在建立的连接数
+
+private:
+    struct IdleConnection {
+        TcpConnectionPtr conn;
+        MonoTimestamp since;  // 归还时间
+    };
+    using IdleList = std::vector<IdleConnection>;
+
+    void newConnection(Connector* connector, int sockfd, const AcquireCallback& cb);
+    void connectFailed(Connector* connector, const AcquireCallback& cb);
+    void dropConnector(Connector* connector);  // 在回调之外销毁 Connector
+    void removeConnection(const TcpConnectionPtr& conn);
+    void expireIdle();
+    bool isIdle(const TcpConnectionPtr& conn) const;
+
+    EventLoop* loop_;
+    const std::string name_;
+    const std::shared_ptr<const std::string> connNamePrefix_;  // 池内连接共享的连接名前缀
+    uint64_t nextConnId_;
+
+    // ==== 配置 ====
+    size_t maxIdlePerKey_;
+    double idleTimeout_;
+    double connectTimeout_;
+    double initRetryDelay_;
+    double maxRetryDelay_;
+    int maxAttempts_;
+    TimerId expireTimer_;
+
+    // ==== 连接状态 ====
+    std::unordered_map<std::string, IdleList> idle_;  // 上游 "ip:port" => 空闲连接
+    std::unordered_map<TcpConnection*, TcpConnectionPtr> live_;  // 全部已建立的连接
+    std::unordered_map<Connector*, std::shared_ptr<Connector>> pending_;  // 建连中
+    std::shared_ptr<void> alive_;  // 延后执行的任务据此判断池是否已销毁
+};
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <stdint.h>
+
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Acceptor.h"
 #include "Buffer.h"
@@ -13,26 +16,103 @@
 #include "EventLoopThreadPool.h"
 #include "InetAddress.h"
 #include "NonCopyable.h"
+#include "SocketOptions.h"
 #include "TcpConnection.h"
+#include "TimerId.h"
+#include "Timestamp.h"
 
 // 对外的服务器编程使用的类
 class TcpServer {
 public:
     using ThreadInitCallback = std::function<void(EventLoop*)>;
+    using DrainCallback = std::function<void()>;
 
     enum Option {
         kNoReusePort,  // 不允许重用本地端口
         kReusePort,  // 允许重用本地端口
+        kReusePortPerLoop,  // 每个subloop各自持有SO_REUSEPORT监听套接字，连接在接收它的loop中处理
+    };
+
+    // kReusePortPerLoop 模式下内核在各监听套接字间分流的方式
+    enum ReusePortSteering {
+        kSteerHash,  // 内核默认：按四元组哈希
+        kSteerIncomingCpu,  // SO_INCOMING_CPU：每个loop优先接收其绑定CPU上的连接（未绑核时loop i对应CPU i）
+        kSteerCbpfCpu,  // cBPF程序：按 当前CPU % loop数 选择监听套接字
     };
 
+    // listenAddr 可为IPv4、IPv6或Unix域地址（见 InetAddress），连接名前缀取自该地址
     TcpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& nameArg, Option option = kNoReusePort);
     ~TcpServer();
 
+    // 追加监听地址（如同时监听TCP端口与本机Unix域套接字），所有地址的连接共用回调与线程池；需在 start() 之前、mainLoop线程调用
+    // kReusePortPerLoop 模式下每个IP地址各建一组per-loop监听套接字，Unix 域地址仍由主loop接收后分发
+    void addListenAddress(const InetAddress& listenAddr);
+    std::vector<InetAddress> listenAddresses() const;
+
+    // 热重启：由已绑定的监听fd构造（如从旧进程经 SCM_RIGHTS 收到或继承的fd，见 HotRestart），start() 后立即accept
+    // 接管的fd总在主loop中accept，kReusePortPerLoop 模式下不再为其地址建per-loop监听套接字
+    TcpServer(EventLoop* loop, int listenFd, const std::string& nameArg, Option option = kNoReusePort);
+    void addListenFd(int listenFd);  // 需在 start() 之前、mainLoop线程调用
+    // 主loop各acceptor的监听fd（顺序同 listenAddresses()），用于交给新进程；kReusePortPerLoop 模式的per-loop监听套接字不在其中
+    std::vector<int> listenFds() const;
+
     void setThreadInitCallback(const ThreadInitCallback& cb) { threadInitCallback_ = cb; }
     void setConnectionCallback(const ConnectionCallback& cb) { connectionCallback_ = cb; }
     void setMessageCallback(const MessageCallback& cb) { messageCallback_ = cb; }
     void setWriteCompleteCallback(const WriteCompleteCallback& cb) { writeCompleteCallback_ = cb; }
 
+    // 连接超时（秒，<=0 表示不启用），需在 start() 之前设置
+    void setIdleTimeout(double seconds) { idleTimeout_ = seconds; }  // 无读写活动
+    void setHeaderReadTimeout(double seconds) { headerReadTimeout_ = seconds; }  // 建连/新请求开始后未读完请求头
+    void setWriteStallTimeout(double seconds) { writeStallTimeout_ = seconds; }  // 输出积压但无写进展
+
+    // 边缘触发模式（仅epoll后端生效），ioBudget为单连接每轮读/写字节上限，需在 start() 之前设置
+    void setEdgeTriggered(bool on, size_t ioBudget = kDefaultIoBudget);
+
+    // 需在 start() 之前设置，仅 kReusePortPerLoop 模式生效
+    void setReusePortSteering(ReusePortSteering steering) { steering_ = steering; }
+
+    // 新连接分配策略，需在 start() 之前设置（kReusePortPerLoop 模式由内核分流，不使用该策略）
+    void setPlacementPolicy(EventLoopThreadPool::PlacementPolicy policy) { threadPool_->setPlacementPolicy(policy); }
+    void setPlacementFunction(EventLoopThreadPool::PlacementFunction fn) { threadPool_->setPlacementFunction(std::move(fn)); }
+
+    // 绑核，需在 start() 之前设置：subloop i 绑定到 cpus[i % cpus.size()]；mainLoop 在 start() 时于其所在线程绑定
+    void setThreadCpuList(std::vector<int> cpus) { threadPool_->setCpuList(std::move(cpus)); }
+    void setMainLoopCpuAffinity(std::vector<int> cpus) { mainLoopCpus_ = std::move(cpus); }
+
+    // 忙轮询，需在 start() 之前设置：loopSpinMicros 为各subloop的自旋预算上限，
+    // socketBusyPollMicros > 0 时对新连接设置 SO_BUSY_POLL
+    void setBusyPoll(int64_t loopSpinMicros, int socketBusyPollMicros = 0) {
+        busyPollMicros_ = loopSpinMicros;
+        socketBusyPollMicros_ = socketBusyPollMicros;
+    }
+
+    // MSG_ZEROCOPY：新连接上不小于 threshold 字节的 BufferSlice 以零拷贝发送（0表示关闭），需在 start() 之前设置
+    // 零拷贝有锁页与完成通知的固定开销，阈值一般取数十KB以上
+    void setZeroCopyThreshold(size_t threshold) { zeroCopyThreshold_ = threshold; }
+
+    // 输出积压读反压，需在 start() 之前设置：单连接输出链内存达到 highMark 时暂停读取该连接，降到 lowMark 后恢复
+    // （0表示关闭）；setOutputMemoryBudget 为所有连接的输出内存总量设上限，超限时暂停积压超过 lowMark 的连接
+    void setOutputBackpressure(size_t highMark, size_t lowMark) {
+        backpressureHigh_ = highMark;
+        backpressureLow_ = lowMark;
+    }
+    void setOutputMemoryBudget(size_t bytes) { outputBudget_ = bytes > 0 ? std::make_shared<OutputBudget>(bytes) : nullptr; }
+    size_t outputMemoryUsed() const { return outputBudget_ ? outputBudget_->used() : 0; }  // 仅在设置预算后统计
+
+    // 连接数上限（0表示不限制）：达到上限时暂停accept，连接留在内核队列中，降到上限以下后恢复
+    // 单acceptor时精确生效；kReusePortPerLoop 模式下各loop并发accept，可能略微超出；需在 start() 之前设置
+    void setMaxConnections(size_t n) { maxConnections_ = n; }
+    // 每次可读事件最多accept的连接数，需在 start() 之前设置
+    void setMaxAcceptsPerEvent(size_t n);
+    // 监听套接字与新连接的套接字选项（见 SocketOptions），需在 start() 之前设置
+    void setSocketOptions(const SocketOptions& opts);
+    size_t numConnections() const { return numConnections_.load(std::memory_order_relaxed); }
+
+    // 各loop的运行统计（线程安全，start之后调用），顺序与线程池中的loop一致
+    std::vector<LoopStats> loopStats() const { return threadPool_->getAllStats(); }
+    LoopStats aggregateLoopStats() const { return threadPool_->aggregateStats(); }
+
     // 设置底层subloop的个数
     void setThreadNum(int numThreads);
     /**
@@ -44,33 +124,93 @@ public:
 
     void stop();
 
+    // 优雅停机（线程安全）：关闭监听套接字，对每个连接执行排空动作（默认 shutdown：输出发完后关闭写端），
+    // 之后周期检查剩余连接；全部关闭或超过 timeoutSeconds 后强制关闭剩余连接，
+    // 最后调用 doneCb（未设置时调用 stop() 退出所有loop，线程随 TcpServer 析构回收）
+    // listenFdsHandedOver 为 true 表示 listenFds() 已交给新进程：这些监听套接字只暂停accept，由新进程继续服务
+    void drain(double timeoutSeconds, DrainCallback doneCb = DrainCallback(), bool listenFdsHandedOver = false);
+    // 排空开始时（及排空期间新建立的连接）在连接所属loop中调用，替代默认的 shutdown；需在 drain() 之前设置
+    void setConnectionDrainCallback(const ConnectionCallback& cb) { connectionDrainCallback_ = cb; }
+    bool draining() const { return draining_.load(std::memory_order_relaxed); }  // 排空进度见 numConnections()
+
+    EventLoop* getLoop() const { return loop_; }  // 获取 mainLoop
+
 private:
-    using ConnectionMap = std::unordered_map<std::string, TcpConnectionPtr>;
+    TcpServer(EventLoop* loop, const std::string& nameArg, Option option, const std::string& ipPort);  // 委托构造：不含acceptor
+
+    static constexpr size_t kDefaultIoBudget = 256 * 1024;
+    static constexpr double kDrainCheckInterval = 0.1;  // 排空进度检查周期（秒）
+
+    using ConnectionMap = std::unordered_map<uint64_t, TcpConnectionPtr>;
     // ==== 核心组件 ====
     EventLoop* loop_;  // Main Reactor（必须首位）
-    const std::string ipPort_;  // 监听地址（格式 "IP:PORT"）
+    const std::string ipPort_;  // 首个监听地址（格式 "IP:PORT"）
     const std::string name_;  // 服务名称
+    const std::shared_ptr<const std::string> connNamePrefix_;  // 连接名前缀 "name-IP:PORT"，所有连接共享
 
     // ==== 网络资源 ====
-    std::unique_ptr<Acceptor> acceptor_;  // 连接接收器（主循环）
+    std::vector<std::shared_ptr<Acceptor>> acceptors_;  // 主循环的连接接收器，每个监听地址一个（首个为构造时的地址）
+    std::vector<std::shared_ptr<Acceptor>> loopAcceptors_;  // kReusePortPerLoop 模式下每个subloop的接收器
     std::shared_ptr<EventLoopThreadPool> threadPool_;  // 线程池
 
     // ==== 连接管理 ====
-    ConnectionMap connections_;  // 活跃连接表（核心状态）
-    std::atomic_int nextConnId_;  // 连接ID生成器
+    // 按ioLoop分片的活跃连接表：登记、移除、销毁都在连接所属loop中完成，无跨线程往返
+    // 分片集合在 start() 中建立，之后只读；各分片只由对应loop线程访问
+    std::unordered_map<EventLoop*, ConnectionMap> shards_;
+    std::atomic<uint64_t> nextConnId_;  // 连接ID生成器
 
     // ==== 配置参数 ====
+    const Option option_;  // 端口重用模式
+    ReusePortSteering steering_;  // reuseport分流方式
     int numThreads_;  // 子线程数
     std::atomic_int started_;  // 启动状态标志
+    double idleTimeout_;  // 空闲超时
+    double headerReadTimeout_;  // 请求头读取超时
+    double writeStallTimeout_;  // 写停滞超时
+    bool edgeTriggered_;  // 是否启用EPOLLET
+    size_t ioBudget_;  // ET模式单连接每轮I/O预算
+    std::vector<int> mainLoopCpus_;  // mainLoop绑核列表
+    int64_t busyPollMicros_;  // subloop自旋预算上限
+    int socketBusyPollMicros_;  // 新连接的SO_BUSY_POLL
+    size_t zeroCopyThreshold_;  // MSG_ZEROCOPY阈值
+    size_t backpressureHigh_;  // 输出积压读反压高水位
+    size_t backpressureLow_;
+    std::shared_ptr<OutputBudget> outputBudget_;  // 所有连接共享的输出内存预算
+    size_t maxConnections_;  // 连接数上限
+    size_t maxAcceptsPerEvent_;  // 每次事件accept上限
+    SocketOptions socketOptions_;  // 监听套接字与新连接的套接字选项
+    std::atomic<size_t> numConnections_;  // 当前连接数（kReusePortPerLoop模式下由多个loop更新）
+    std::atomic_bool acceptPaused_;  // 是否因达到上限暂停accept
+
+    // ==== 优雅停机（除 draining_ 外仅在主loop中访问）====
+    std::atomic_bool draining_;  // 是否处于排空模式（ioLoop读取）
+    bool drainForced_;  // 是否已在截止时间强制关闭剩余连接
+    MonoTimestamp drainDeadline_;
+    TimerId drainTimer_;
+    DrainCallback drainDoneCallback_;
 
     // ==== 用户回调 ====
     ConnectionCallback connectionCallback_;
     MessageCallback messageCallback_;
     WriteCompleteCallback writeCompleteCallback_;
     ThreadInitCallback threadInitCallback_;
+    ConnectionCallback connectionDrainCallback_;
 
     // ==== 内部方法 ====
-    void newConnection(int sockfd, const InetAddress& peerAddr);
-    void removeConnection(const TcpConnectionPtr& conn);
-    void removeConnectionInLoop(const TcpConnectionPtr& conn);
+    void newConnection(int sockfd, const InetAddress& peerAddr);  // 主loop接收，分发给subloop
+    void newConnectionBatch(const Acceptor::AcceptedList& accepted);  // 主loop批量接收，按subloop分组分发
+    void newConnectionInLoop(EventLoop* ioLoop, int sockfd, const InetAddress& peerAddr);  // 在ioLoop中建立连接
+    TcpConnectionPtr createConnection(EventLoop* ioLoop, int sockfd, const InetAddress& peerAddr);  // 创建并登记连接
+    size_t acceptQuota() const;  // 距离连接上限还可接受的连接数
+    void setAccepting(bool on);  // 暂停/恢复所有acceptor
+    void closeAcceptors(bool keepMainAcceptors);  // 排空开始时关闭监听套接字
+    std::vector<Acceptor*> allAcceptors() const;
+    void addMainAcceptor(std::shared_ptr<Acceptor> acceptor);
+    void startLoopAcceptors();
+    void forEachConnection(const ConnectionCallback& fn);  // 在各ioLoop中对其全部连接执行fn
+    void drainConnection(const TcpConnectionPtr& conn);  // 在ioLoop中执行
+    void checkDrain();
+    void finishDrain();
+    void connectEstablishedInLoop(const TcpConnectionPtr& conn);  // 在ioLoop中登记到本loop分片并建立连接
+    void removeConnection(const TcpConnectionPtr& conn);  // 关闭回调，在ioLoop中执行
 };
\ No newline at end of file
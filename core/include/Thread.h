@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "NonCopyable.h"
 
@@ -17,6 +18,9 @@ public:
     explicit Thread(ThreadFunc func, const std::string& name = std::string());
     ~Thread();
 
+    // 线程启动时绑定到cpus（需在start()之前设置）
+    void setCpuAffinity(std::vector<int> cpus) { cpus_ = std::move(cpus); }
+
     void start();
     void join();
     bool isStarted() { return started_; }
@@ -34,6 +38,7 @@ private:
     // ==== 线程标识信息 ====
     pid_t tid_;  // 系统线程ID
     std::string name_;  // 线程名称
+    std::vector<int> cpus_;  // 绑核列表（空表示不绑定）
 
     // ==== 执行逻辑 ====
     ThreadFunc func_;  // 线程执行函数
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+
+#include "Callbacks.h"
+#include "NonCopyable.h"
+#include "Timestamp.h"
+
+// 定时器：封装到期时间、回调以及重复间隔，由 TimerQueue 统一管理
+class Timer : NonCopyable {
+public:
+    Timer(TimerCallback cb, MonoTimestamp when, double interval);
+
+    void run() const { callback_(); }  // 执行定时回调
+
+    MonoTimestamp expiration() const { return expiration_; }  // 到期时间（单调时钟）
+    bool repeat() const { return repeat_; }  // 是否为周期定时器
+    int64_t sequence() const { return sequence_; }  // 全局唯一序号
+
+    // 周期定时器到期后，以now为基准计算下一次到期时间
+    void restart(MonoTimestamp now);
+
+    static int64_t numCreated() { return numCreated_.load(); }
+
+private:
+    // ==== 定时属性 ====
+    const TimerCallback callback_;  // 定时回调
+    MonoTimestamp expiration_;  // 到期时间
+    const double interval_;  // 重复间隔（秒），<=0 表示一次性
+    const bool repeat_;  // 是否重复
+    const int64_t sequence_;  // 序号，区分地址复用的Timer对象
+
+    // ==== 类共享状态 ====
+    static std::atomic<int64_t> numCreated_;  // 定时器计数
+};
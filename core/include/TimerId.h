@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+class Timer;
+
+// 对外暴露的定时器句柄，仅用于取消定时器（可拷贝）
+class TimerId {
+public:
+    TimerId() : timer_(nullptr), sequence_(0) {}
+    TimerId(Timer* timer, int64_t seq) : timer_(timer), sequence_(seq) {}
+
+    bool valid() const { return timer_ != nullptr; }
+
+    friend class TimerQueue;
+
+private:
+    Timer* timer_;  // 定时器对象（仅作为查找键，不可解引用）
+    int64_t sequence_;  // 定时器序号
+};
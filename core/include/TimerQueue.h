@@ -0,0 +1,60 @@
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "Callbacks.h"
+#include "Channel.h"
+#include "NonCopyable.h"
+#include "TimerId.h"
+#include "Timestamp.h"
+
+class EventLoop;
+class Timer;
+
+/**
+ * TimerQueue: 每个 EventLoop 持有一个定时器队列
+ * 通过 timerfd 将定时事件接入 Poller，与普通IO事件统一由 loop 分发
+ * 到期时间使用单调时钟（与 timerfd 的 CLOCK_MONOTONIC 一致），系统时间跳变不影响定时器
+ * addTimer/cancel 可跨线程调用，真正的修改总是在所属 loop 线程中完成
+ */
+class TimerQueue : NonCopyable {
+public:
+    explicit TimerQueue(EventLoop* loop);
+    ~TimerQueue();
+
+    // 添加定时器，interval > 0 表示周期执行（线程安全）
+    TimerId addTimer(TimerCallback cb, MonoTimestamp when, double interval);
+
+    // 取消定时器（线程安全）
+    void cancel(TimerId timerId);
+
+private:
+    // 按到期时间排序，到期时间相同则按地址区分
+    using Entry = std::pair<MonoTimestamp, Timer*>;
+    using TimerList = std::set<Entry>;
+    // 按对象地址+序号索引，用于取消
+    using ActiveTimer = std::pair<Timer*, int64_t>;
+    using ActiveTimerSet = std::set<ActiveTimer>;
+
+    // ==== 核心组件 ====
+    EventLoop* loop_;  // 所属事件循环（必须首位）
+    const int timerfd_;  // timerfd 描述符
+    Channel timerfdChannel_;  // 监听 timerfd 可读事件
+
+    // ==== 定时器集合 ====
+    TimerList timers_;  // 按到期时间排序的定时器
+    ActiveTimerSet activeTimers_;  // 与timers_保存相同的定时器，供cancel查找
+
+    // ==== 回调执行期间的取消处理 ====
+    bool callingExpiredTimers_;  // 是否正在执行到期回调
+    ActiveTimerSet cancelingTimers_;  // 回调执行期间被取消的定时器
+
+    // ==== 内部方法 ====
+    void addTimerInLoop(Timer* timer);
+    void cancelInLoop(TimerId timerId);
+    void handleRead();  // timerfd 可读：执行所有到期定时器
+    std::vector<Entry> getExpired(MonoTimestamp now);  // 取出所有到期的定时器
+    void reset(const std::vector<Entry>& expired, MonoTimestamp now);  // 重新插入周期定时器并刷新timerfd
+    bool insert(Timer* timer);  // 插入定时器，返回是否成为最早到期者
+};
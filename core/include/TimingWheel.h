@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+#include "NonCopyable.h"
+#include "TimerId.h"
+
+class EventLoop;
+
+/**
+ * TimingWheel: 每个 EventLoop 持有的分层时间轮（4层 x 64槽）
+ * 用于海量连接的空闲/读超时/写停滞检测，所有操作均需在 loop 线程中调用
+ *
+ * - schedule/cancel: O(1) 链表插入/摘除
+ * - touch: 只更新截止tick，不移动节点；节点到期时若截止时间已被推迟则重新挂入
+ * - 由 TimerQueue 的周期定时器驱动，时间轮为空时自动停止 tick
+ */
+class TimingWheel : NonCopyable {
+private:
+    // 侵入式双向链表节点
+    struct Link {
+        Link* prev = nullptr;
+        Link* next = nullptr;
+    };
+
+public:
+    using Callback = std::function<void()>;
+
+    // 时间轮条目，由使用者持有（通常嵌入在 TcpConnection 中），析构时自动摘除
+    class Entry : Link, NonCopyable {
+    public:
+        explicit Entry(Callback cb = Callback()) : callback_(std::move(cb)) {}
+        ~Entry() { unlink(); }
+
+        void setCallback(Callback cb) { callback_ = std::move(cb); }
+        bool linked() const { return wheel_ != nullptr; }
+
+    private:
+        friend class TimingWheel;
+        void unlink();
+
+        TimingWheel* wheel_ = nullptr;  // 所在时间轮，nullptr表示未挂入
+        uint64_t expire_ = 0;  // 所在槽对应的到期tick
+        uint64_t deadline_ = 0;  // 实际截止tick（touch只更新它）
+        Callback callback_;  // 到期回调
+    };
+
+    explicit TimingWheel(EventLoop* loop, double tickSeconds = 1.0);
+    ~TimingWheel();
+
+    // (重新)挂入条目，timeout秒后触发
+    void schedule(Entry* entry, double timeout);
+    // 推迟条目的截止时间：已挂入时只更新截止tick，未挂入时等同于schedule
+    void touch(Entry* entry, double timeout);
+    // 摘除条目
+    void cancel(Entry* entry) { entry->unlink(); }
+
+    size_t size() const { return size_; }
+    double tickSeconds() const { return tickSeconds_; }
+
+private:
+    static const int kLevels = 4;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;  // 每层64个槽
+    static const uint64_t kSlotMask = kSlots - 1;
+    static const uint64_t kMaxTicks = (uint64_t{1} << (kLevels * kSlotBits)) - 1;  // 时间轮可表示的最大跨度
+
+    using Slot = Link;  // 槽即链表哨兵
+
+    // ==== 核心组件 ====
+    EventLoop* loop_;  // 所属事件循环（必须首位）
+    const double tickSeconds_;  // 每个tick的时长（秒）
+
+    // ==== 时间轮状态 ====
+    std::array<std::array<Slot, kSlots>, kLevels> wheels_;  // 分层槽位
+    uint64_t currentTick_;  // 当前tick
+    size_t size_;  // 已挂入的条目数
+
+    // ==== tick 驱动 ====
+    TimerId tickTimer_;  // 驱动时间轮的周期定时器
+    bool ticking_;  // 周期定时器是否在运行
+
+    // ==== 内部方法 ====
+    uint64_t toTicks(double timeout) const;
+    void insert(Entry* entry);  // 按 expire_ 放入对应层的槽
+    void cascade(int level);  // 将高层槽中的条目下放到低层
+    void onTick();  // 推进一个tick并触发到期条目
+    void startTicking();
+    void stopTicking();
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Channel.h"
+#include "InetAddress.h"
+#include "NonCopyable.h"
+#include "Socket.h"
+#include "Timestamp.h"
+
+class EventLoop;
+class UdpChannel;
+
+// 收到的单个数据报：data 指向 UdpChannel 的接收区，只在回调期间有效
+struct Datagram {
+    InetAddress peer;
+    const char* data;
+    size_t size;
+};
+using DatagramBatch = std::vector<Datagram>;
+// 一次 recvmmsg 收到的全部数据报一并交付；batch.size() 即本批数据报数（GRO合并的报文已拆开计数）
+using DatagramBatchCallback = std::function<void(UdpChannel*, const DatagramBatch&, Timestamp)>;
+
+/**
+ * UdpStats: 单个 UdpChannel 的收发统计快照（可累加）
+ * 批量直方图第0桶为1个数据报，第i桶为 [2^i, 2^(i+1)) 个，用于判断批量化是否生效
+ */
+struct UdpStats {
+    static constexpr size_t kBatchBuckets = 8;  // 最大一桶收纳 >=128
+
+    uint64_t recvCalls = 0;  // 返回数据的 recvmmsg 次数
+    uint64_t datagramsReceived = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t groDatagrams = 0;  // 经GRO合并到达的数据报数
+    uint64_t truncated = 0;  // 超出接收区被截断而丢弃的数据报
+    uint64_t maxRecvBatch = 0;
+    std::array<uint64_t, kBatchBuckets> recvBatchHistogram{};
+
+    uint64_t sendCalls = 0;  // sendmmsg 次数
+    uint64_t datagramsSent = 0;
+    uint64_t bytesSent = 0;
+    uint64_t gsoMessages = 0;  // 以UDP_SEGMENT发送的合并报文数
+    uint64_t maxSendBatch = 0;
+    std::array<uint64_t, kBatchBuckets> sendBatchHistogram{};
+    uint64_t sendDrops = 0;  // 发送队列超限丢弃
+    uint64_t sendErrors = 0;  // 内核拒绝发送的数据报（如ICMP不可达、超长）
+
+    UdpStats& operator+=(const UdpStats& other);
+    double avgRecvBatch() const;
+    double avgSendBatch() const;
+
+    static size_t batchBucket(uint64_t count);
+};
+
+/**
+ * UdpChannel: 绑定在单个 EventLoop 上的 UDP 套接字
+ * - 接收：可读时以 recvmmsg 一次收取最多 recvBatch 个数据报，收入预分配的接收区（每个槽位一个数据报），
+ *   接收区在 start() 时一次分配、之后每批复用；开启GRO时每个槽位按64KB分配，内核合并的报文在交付前拆开
+ * - 发送：send() 把数据报拷入发送区排队，本轮事件循环末尾以 sendmmsg 批量发出；
+ *   支持UDP_SEGMENT时，发往同一对端、长度相同的连续数据报合并为一个GSO报文
+ * - 除 send() 外的方法仅在所属loop线程调用；send() 可跨线程调用（数据被拷贝后投递）
+ * - 须由 shared_ptr 持有：投递到loop的发送与flush任务持有 shared_from_this()
+ */
+class UdpChannel : NonCopyable, public std::enable_shared_from_this<UdpChannel> {
+public:
+    static constexpr size_t kDefaultBatch = 32;
+    static constexpr size_t kDefaultDatagramSize = 2048;  // 不开GRO时的单个接收槽位，超长的数据报被截断丢弃
+    static constexpr size_t kDefaultMaxQueuedBytes = 4 * 1024 * 1024;
+
+    UdpChannel(EventLoop* loop, const InetAddress& bindAddr, bool reusePort, const std::string& name);
+    ~UdpChannel();  // 需在所属loop线程析构
+
+    // 以下配置需在 start() 之前设置
+    void setDatagramBatchCallback(DatagramBatchCallback cb) { batchCallback_ = std::move(cb); }
+    void setRecvBatch(size_t n) { recvBatch_ = n > 0 ? n : 1; }  // 每次 recvmmsg 的数据报上限
+    void setSendBatch(size_t n) { sendBatch_ = n > 0 ? n : 1; }  // 每次 sendmmsg 的报文上限
+    void setMaxDatagramSize(size_t n) { datagramSize_ = n; }
+    void setMaxQueuedBytes(size_t n) { maxQueuedBytes_ = n; }  // 发送队列上限，超出的数据报丢弃
+    void setGro(bool on) { groRequested_ = on; }  // UDP_GRO（Linux 5.0+），接收区每槽位64KB
+    void setGso(bool on) { gsoEnabled_ = on; }  // UDP_SEGMENT（Linux 4.18+），默认开启，不支持时自动关闭
+
+    void start();  // 在所属loop中开始接收
+
+    void send(const InetAddress& peer, const void* data, size_t len);
+    void send(const InetAddress& peer, const std::string& data) { send(peer, data.data(), data.size()); }
+    void flush();  // 立即发出排队的数据报（仅loop线程，一般无需调用）
+
+    EventLoop* getLoop() const { return loop_; }
+    const std::string& name() const { return name_; }
+    InetAddress localAddress() const { return Socket::getLocalAddr(socket_.getSocketFd()); }
+    bool groEnabled() const { return groEnabled_; }
+    bool gsoEnabled() const { return gsoEnabled_; }
+    size_t queuedBytes() const { return sendArena_.size() - sendArenaHead_; }  // 仅loop线程
+    UdpStats stats() const;  // 任意线程
+
+private:
+    // 排队等待发送的数据报（数据在 sendArena_ 中连续存放）
+    struct PendingDatagram {
+        InetAddress peer;
+        size_t offset;
+        size_t size;
+    };
+
+    // 只由loop线程写入，任意线程可读取快照
+    struct Counters {
+        std::atomic<uint64_t> recvCalls{0};
+        std::atomic<uint64_t> datagramsReceived{0};
+        std::atomic<uint64_t> bytesReceived{0};
+        std::atomic<uint64_t> groDatagrams{0};
+        std::atomic<uint64_t> truncated{0};
+        std::atomic<uint64_t> maxRecvBatch{0};
+        std::array<std::atomic<uint64_t>, UdpStats::kBatchBuckets> recvBatchHistogram{};
+        std::atomic<uint64_t> sendCalls{0};
+        std::atomic<uint64_t> datagramsSent{0};
+        std::atomic<uint64_t> bytesSent{0};
+        std::atomic<uint64_t> gsoMessages{0};
+        std::atomic<uint64_t> maxSendBatch{0};
+        std::array<std::atomic<uint64_t>, UdpStats::kBatchBuckets> sendBatchHistogram{};
+        std::atomic<uint64_t> sendDrops{0};
+        std::atomic<uint64_t> sendErrors{0};
+    };
+
+    // ==== 核心组件 ====
+    EventLoop* loop_;  // 所属事件循环（必须首位）
+    const std::string name_;
+    Socket socket_;
+    Channel channel_;
+
+    // ==== 配置 ====
+    size_t recvBatch_;
+    size_t sendBatch_;
+    size_t datagramSize_;
+    size_t maxQueuedBytes_;
+    bool groRequested_;
+    bool groEnabled_;
+    bool gsoEnabled_;
+
+    // ==== 接收区（start时按批量与槽位大小一次分配）====
+    size_t slotSize_;
+    std::unique_ptr<char[]> recvArena_;
+    std::vector<mmsghdr> recvMsgs_;
+    std::vector<iovec> recvIovecs_;
+    std::vector<sockaddr_storage> recvAddrs_;
+    std::unique_ptr<char[]> recvControl_;  // 每个槽位一段cmsg空间（GRO分段长度）
+    DatagramBatch batch_;
+
+    // ==== 发送队列 ====
+    std::vector<char> sendArena_;
+    size_t sendArenaHead_;  // 已发出部分的末尾，队列清空时归零
+    std::vector<PendingDatagram> sendQueue_;
+    size_t sendQueueHead_;
+    size_t plainDatagrams_;  // 队首起不做GSO合并的数据报数（合并报文被内核以EINVAL拒绝后拆开重发）
+    bool flushQueued_;  // 本轮已投递flush任务
+    std::vector<mmsghdr> sendMsgs_;
+    std::vector<iovec> sendIovecs_;
+    std::vector<size_t> sendMsgDatagrams_;  // 本批每个报文包含的数据报数
+    std::unique_ptr<char[]> sendControl_;  // 每个报文一段cmsg空间（GSO分段长度）
+
+    Counters counters_;
+    DatagramBatchCallback batchCallback_;
+
+    // ==== 内部方法 ====
+    void handleRead(Timestamp receiveTime);
+    void handleWrite();
+    void enqueue(const InetAddress& peer, const char* data, size_t len);
+    size_t buildSendBatch();  // 从队首组装最多 sendBatch_ 个报文，返回报文数
+    void advanceSendQueue(size_t datagrams);  // 出队已发出（或放弃）的数据报
+};
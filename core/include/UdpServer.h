@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EventLoop.h"
+#include "EventLoopThreadPool.h"
+#include "InetAddress.h"
+#include "NonCopyable.h"
+#include "UdpChannel.h"
+
+/**
+ * UdpServer: 基于 EventLoop 的 UDP 服务端
+ * - kSingleSocket：一个套接字，在主loop中收发
+ * - kReusePortPerLoop：每个loop各自绑定一个 SO_REUSEPORT 套接字，内核按四元组分流，
+ *   同一对端的数据报固定落在同一loop，收发都不跨线程
+ * 批量回调的 UdpChannel* 即收到数据报的套接字，应答应经它发送
+ */
+class UdpServer : NonCopyable {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop*)>;
+
+    enum Option {
+        kSingleSocket,
+        kReusePortPerLoop,
+    };
+
+    UdpServer(EventLoop* loop, const InetAddress& bindAddr, const std::string& nameArg, Option option = kSingleSocket);
+    ~UdpServer();
+
+    // 以下配置需在 start() 之前设置
+    void setThreadNum(int numThreads) { threadPool_->setThreadNum(numThreads); }  // 仅 kReusePortPerLoop 模式使用子线程
+    void setThreadInitCallback(const ThreadInitCallback& cb) { threadInitCallback_ = cb; }
+    void setDatagramBatchCallback(const DatagramBatchCallback& cb) { batchCallback_ = cb; }
+    void setRecvBatch(size_t n) { recvBatch_ = n; }
+    void setSendBatch(size_t n) { sendBatch_ = n; }
+    void setMaxDatagramSize(size_t n) { maxDatagramSize_ = n; }
+    void setMaxQueuedBytes(size_t n) { maxQueuedBytes_ = n; }
+    void setGro(bool on) { gro_ = on; }
+    void setGso(bool on) { gso_ = on; }
+
+    void start();  // 多次调用没有副作用
+
+    const std::string& name() const { return name_; }
+    EventLoop* getLoop() const { return loop_; }
+
+    // 收发统计（线程安全，start之后调用）
+    std::vector<UdpStats> channelStats() const;  // 每个套接字一项
+    UdpStats stats() const;  // 汇总
+
+private:
+    // ==== 核心组件 ====
+    EventLoop* loop_;  // 主loop（必须首位）
+    const InetAddress bindAddr_;
+    const std::string name_;
+    const Option option_;
+    std::shared_ptr<EventLoopThreadPool> threadPool_;
+    std::vector<std::shared_ptr<UdpChannel>> channels_;  // start() 后只读
+
+    // ==== 配置 ====
+    std::atomic_int started_;
+    size_t recvBatch_;
+    size_t sendBatch_;
+    size_t maxDatagramSize_;
+    size_t maxQueuedBytes_;
+    bool gro_;
+    bool gso_;
+
+    // ==== 用户回调 ====
+    DatagramBatchCallback batchCallback_;
+    ThreadInitCallback threadInitCallback_;
+};
@@ -1,59 +1,215 @@
 #include "Acceptor.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+
+#include "EventLoop.h"
 #include "InetAddress.h"
 #include "LogMacros.h"
 
-static int createNonBlockingSocket() {
-    int sockfd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+// 默认每次可读事件最多accept的连接数，兼顾连接风暴下的吞吐与其他事件的响应
+static const size_t kDefaultMaxAcceptsPerEvent = 64;
+
+static int openIdleFd() {
+    return ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+static int createNonBlockingSocket(sa_family_t family) {
+    int sockfd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (sockfd < 0) {
         LOG_FATAL("isten socket create err:{}", errno);
     }
     return sockfd;
 }
 
+// Unix 域文件路径在监听套接字关闭后仍留在文件系统中，重启时先删除残留的套接字文件，否则bind返回EADDRINUSE
+// 仅当连接被拒绝（无人监听）时才视为残留；仍有进程在监听时删除会让它再也收不到新连接，按地址占用处理
+static void removeStaleUnixSocket(const InetAddress& addr) {
+    if (!addr.isUnix() || addr.isAbstract()) {
+        return;
+    }
+    const std::string path = addr.toIp();
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode)) {
+        return;
+    }
+    int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        LOG_FATAL("unix socket probe create err:{}", errno);
+    }
+    int ret = ::connect(probe, addr.getSockAddr(), addr.getSockLen());
+    int savedErrno = errno;
+    ::close(probe);
+    if (ret == 0 || savedErrno == EAGAIN) {  // EAGAIN：对端全连接队列已满，同样有进程在监听
+        LOG_FATAL("unix socket {} is in use by a running server, err:{}", path, EADDRINUSE);
+    }
+    if (savedErrno == ECONNREFUSED && ::unlink(path.c_str()) != 0) {
+        LOG_WARN("unlink stale unix socket {} err:{}", path, errno);
+    }
+}
+
 Acceptor::Acceptor(EventLoop* loop, const InetAddress& listenAddr, bool reusePort) :
     loop_(loop),  // 初始化事件循环指针
-    acceptSocket_(createNonBlockingSocket()),  // 创建非阻塞监听套接字
+    acceptSocket_(createNonBlockingSocket(listenAddr.family())),  // 创建非阻塞监听套接字
     acceptChannel_(loop, acceptSocket_.getSocketFd()),  // 创建监听通道
-    listenning_(false)  // 初始状态未开始监听
+    listenAddr_(listenAddr),
+    adopted_(false),
+    listenning_(false),  // 初始状态未开始监听
+    paused_(false),
+    maxAcceptsPerEvent_(kDefaultMaxAcceptsPerEvent),
+    idleFd_(openIdleFd())
 {
-    acceptSocket_.setReuseAddr(true);  // 设置SO_REUSEADDR选项（快速重启）
-    acceptSocket_.setReusePort(reusePort);  // 设置SO_REUSEPORT选项（多线程监听同一端口）
-    acceptSocket_.bindAddress(listenAddr);  // 绑定监听地址（IP+Port）
+    if (listenAddr.isUnix()) {
+        removeStaleUnixSocket(listenAddr);  // Unix 域不支持端口重用，各acceptor须使用不同路径
+    } else {
+        acceptSocket_.setReuseAddr(true);  // 设置SO_REUSEADDR选项（快速重启）
+        acceptSocket_.setReusePort(reusePort);  // 设置SO_REUSEPORT选项（多线程监听同一端口）
+    }
+    acceptSocket_.bindAddress(listenAddr);  // 绑定监听地址（IP+Port 或 Unix 域路径）
     // TcpServer::start() => Acceptor.listen() 如果有新用户连接 要执行一个回调(accept => connfd => 打包成Channel => 唤醒subloop)
     // baseloop监听到有事件发生 => acceptChannel_(listenfd) => 执行该回调函数
     acceptChannel_.setReadCallback([this](Timestamp t) { this->handleRead(); });
 }
 
+// 继承或经 SCM_RIGHTS 收到的fd可能是阻塞的，也可能未设置 FD_CLOEXEC
+static int adoptListenFd(int listenFd) {
+    int flags = ::fcntl(listenFd, F_GETFL, 0);
+    if (flags < 0 || ::fcntl(listenFd, F_SETFL, flags | O_NONBLOCK) < 0 || ::fcntl(listenFd, F_SETFD, FD_CLOEXEC) < 0) {
+        LOG_FATAL("adopt listen fd:{} err:{}", listenFd, errno);
+    }
+    return listenFd;
+}
+
+Acceptor::Acceptor(EventLoop* loop, int listenFd) :
+    loop_(loop),
+    acceptSocket_(adoptListenFd(listenFd)),
+    acceptChannel_(loop, acceptSocket_.getSocketFd()),
+    listenAddr_(Socket::getLocalAddr(listenFd)),
+    adopted_(true),
+    listenning_(false),
+    paused_(false),
+    maxAcceptsPerEvent_(kDefaultMaxAcceptsPerEvent),
+    idleFd_(openIdleFd())
+{
+    acceptChannel_.setReadCallback([this](Timestamp t) { this->handleRead(); });
+}
+
 Acceptor::~Acceptor() {
     acceptChannel_.disableAll();  // 把从Poller中感兴趣的事件删除掉
     acceptChannel_.remove();  // 调用EventLoop->removeChannel => Poller->removeChannel 把Poller的ChannelMap对应的部分删除
+    if (idleFd_ >= 0) {
+        ::close(idleFd_);
+    }
 }
 
 void Acceptor::listen() {
     listenning_ = true;
-    acceptSocket_.listen();
-    acceptChannel_.enableReading();  // 核心操作：将acceptChannel_注册到Poller
+    acceptSocket_.applyListenOptions(socketOptions_, !listenAddr_.isUnix());
+    acceptSocket_.listen(socketOptions_.backlog);  // listen() 调用顺序决定该套接字在 reuseport 组内的序号
+    loop_->runInLoop([this] {
+        if (!paused_) {
+            acceptChannel_.enableReading();  // 核心操作：将acceptChannel_注册到Poller
+        }
+    });
+}
+
+void Acceptor::pause() {
+    loop_->runInLoop([weak = weak_from_this()] {
+        auto self = weak.lock();
+        if (self && !self->paused_) {
+            self->paused_ = true;
+            if (self->listenning_) {
+                self->acceptChannel_.disableReading();
+            }
+        }
+    });
+}
+
+void Acceptor::resume() {
+    loop_->runInLoop([weak = weak_from_this()] {
+        auto self = weak.lock();
+        if (self && self->paused_) {
+            self->paused_ = false;
+            if (self->listenning_) {
+                self->acceptChannel_.enableReading();  // 重新注册时若队列非空会立即就绪（ET模式同样成立）
+            }
+        }
+    });
 }
 
 void Acceptor::handleRead() {
-    InetAddress peerAddr;
-    int connfd = acceptSocket_.accept(&peerAddr);
-    if (connfd >= 0) {
-        if (NewConnectionCallback_) {
-            NewConnectionCallback_(connfd, peerAddr);
-        } else {
-            ::close(connfd);
+    // 批量accept：LT模式下未取完的连接下一轮继续；ET模式不会重复通知，达到上限时自行续接
+    size_t limit = maxAcceptsPerEvent_;
+    if (acceptQuotaCallback_) {
+        limit = std::min(limit, acceptQuotaCallback_());
+    }
+    bool budgetExhausted = true;
+    accepted_.clear();
+    while (accepted_.size() < limit) {
+        InetAddress peerAddr;
+        int connfd = acceptSocket_.accept(&peerAddr);
+        if (connfd >= 0) {
+            accepted_.push_back({connfd, peerAddr});
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            budgetExhausted = false;
+            break;
+        }
+        if (errno == ECONNABORTED || errno == EINTR) {
+            continue;  // 对端在三次握手完成后立刻RST，忽略
+        }
+        if ((errno == EMFILE || errno == ENFILE) && rejectOnFdExhausted()) {
+            continue;  // 拒绝一个连接后继续，避免监听fd持续可读导致空转
         }
-    } else {
         LOG_ERROR("accept err:{}", errno);
-        if (errno == EMFILE) {
-            LOG_ERROR("socketfd reached limit:{}", errno);
+        budgetExhausted = false;
+        break;
+    }
+
+    if (!accepted_.empty()) {
+        if (newConnectionBatchCallback_) {
+            newConnectionBatchCallback_(accepted_);
+        } else {
+            for (const AcceptedConnection& conn : accepted_) {
+                if (NewConnectionCallback_) {
+                    NewConnectionCallback_(conn.sockfd, conn.peerAddr);
+                } else {
+                    ::close(conn.sockfd);
+                }
+            }
         }
     }
-}
\ No newline at end of file
+
+    if (budgetExhausted && acceptChannel_.isEdgeTriggered()) {
+        // per-loop acceptor 由 TcpServer::stop() 在同一loop的排队任务中销毁，续接任务可能排在其后
+        loop_->queueInLoop([weak = weak_from_this()] {
+            auto self = weak.lock();
+            if (self && !self->paused_) {
+                self->handleRead();
+            }
+        });
+    }
+}
+
+// fd耗尽时：关闭预留fd腾出位置，accept后立即关闭（对端收到FIN而不是一直挂在队列里），再重新预留
+bool Acceptor::rejectOnFdExhausted() {
+    if (idleFd_ < 0) {
+        idleFd_ = openIdleFd();
+        return false;
+    }
+    LOG_ERROR("socketfd reached limit:{}, reject one connection", errno);
+    ::close(idleFd_);
+    int connfd = ::accept(acceptSocket_.getSocketFd(), nullptr, nullptr);
+    if (connfd >= 0) {
+        ::close(connfd);
+    }
+    idleFd_ = openIdleFd();
+    return connfd >= 0;
+}
@@ -0,0 +1,236 @@
+#include "Connector.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "Channel.h"
+#include "EventLoop.h"
+#include "LogMacros.h"
+#include "Socket.h"
+
+static const double kInitRetryDelaySeconds = 0.5;
+static const double kMaxRetryDelaySeconds = 30.0;
+
+Connector::Connector(EventLoop* loop, const InetAddress& serverAddr) :
+    loop_(loop),
+    serverAddr_(serverAddr),
+    connect_(false),
+    state_(kDisconnected),
+    connectTimeout_(0.0),
+    initRetryDelay_(kInitRetryDelaySeconds),
+    maxRetryDelay_(kMaxRetryDelaySeconds),
+    retryDelay_(kInitRetryDelaySeconds),
+    maxAttempts_(0),
+    attempts_(0),
+    rng_(std::random_device{}()) {}
+
+Connector::~Connector() {
+    cancelTimer(&retryTimer_);
+    cancelTimer(&timeoutTimer_);
+    if (state_ == kConnecting) {
+        // 仍在连接中被销毁：注销通道并关闭尚未交出的 fd
+        int sockfd = channel_->getFd();
+        channel_->disableAll();
+        channel_->remove();
+        ::close(sockfd);
+    }
+}
+
+void Connector::setRetryDelay(double initialSeconds, double maxSeconds) {
+    initRetryDelay_ = initialSeconds;
+    maxRetryDelay_ = std::max(initialSeconds, maxSeconds);
+    retryDelay_ = initRetryDelay_;
+}
+
+void Connector::start() {
+    connect_ = true;
+    loop_->runInLoop([self = shared_from_this()] { self->startInLoop(); });
+}
+
+void Connector::restart() {
+    setState(kDisconnected);
+    retryDelay_ = initRetryDelay_;
+    attempts_ = 0;
+    connect_ = true;
+    startInLoop();
+}
+
+void Connector::stop() {
+    connect_ = false;
+    loop_->queueInLoop([self = shared_from_this()] { self->stopInLoop(); });
+}
+
+void Connector::startInLoop() {
+    if (connect_ && state_ == kDisconnected) {
+        connect();
+    } else {
+        LOG_DEBUG("Connector::startInLoop do not connect, state = {}", static_cast<int>(state_));
+    }
+}
+
+void Connector::stopInLoop() {
+    cancelTimer(&retryTimer_);
+    if (state_ == kConnecting) {
+        cancelTimer(&timeoutTimer_);
+        setState(kDisconnected);
+        ::close(removeAndResetChannel());
+    }
+}
+
+void Connector::connect() {
+    ++attempts_;
+    int sockfd = ::socket(serverAddr_.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sockfd < 0) {
+        LOG_ERROR("Connector::connect socket create err:{}", errno);
+        retry(-1);
+        return;
+    }
+    int ret = ::connect(sockfd, serverAddr_.getSockAddr(), serverAddr_.getSockLen());
+    int savedErrno = (ret == 0) ? 0 : errno;
+    switch (savedErrno) {
+        case 0:
+        case EINPROGRESS:
+        case EINTR:
+        case EISCONN:
+            connecting(sockfd);
+            break;
+
+        // 暂时性失败：退避后重试
+        case EAGAIN:
+        case EADDRINUSE:
+        case EADDRNOTAVAIL:
+        case ECONNREFUSED:
+        case ENETUNREACH:
+        case EHOSTUNREACH:
+        case ETIMEDOUT:
+        case ENOENT:  // Unix 域套接字文件尚未创建（服务端未启动）
+            retry(sockfd);
+            break;
+
+        default:
+            LOG_ERROR("Connector::connect {} unexpected error {}", serverAddr_.toIpPort(), savedErrno);
+            ::close(sockfd);
+            connect_ = false;
+            if (connectFailedCallback_) {
+                connectFailedCallback_();
+            }
+            break;
+    }
+}
+
+void Connector::connecting(int sockfd) {
+    setState(kConnecting);
+    channel_ = std::make_unique<Channel>(loop_, sockfd);
+    channel_->setWriteCallback([this] { handleWrite(); });
+    channel_->setErrorCallback([this] { handleError(); });
+    channel_->enableWriting();
+    if (connectTimeout_ > 0.0) {
+        std::weak_ptr<Connector> weak = shared_from_this();
+        timeoutTimer_ = loop_->runAfter(connectTimeout_, [weak] {
+            if (auto self = weak.lock()) {
+                self->handleTimeout();
+            }
+        });
+    }
+}
+
+int Connector::removeAndResetChannel() {
+    channel_->disableAll();
+    channel_->remove();
+    int sockfd = channel_->getFd();
+    // 可能正处于 Channel::handleEvent 中，不能在此销毁 Channel
+    loop_->queueInLoop([self = shared_from_this()] { self->resetChannel(); });
+    return sockfd;
+}
+
+void Connector::resetChannel() {
+    if (state_ != kConnecting) {
+        channel_.reset();
+    }
+}
+
+void Connector::handleWrite() {
+    if (state_ != kConnecting) {
+        return;
+    }
+    cancelTimer(&timeoutTimer_);
+    int sockfd = removeAndResetChannel();
+    int err = Socket::getSocketError(sockfd);
+    if (err != 0) {
+        LOG_WARN("Connector::handleWrite {} SO_ERROR = {}", serverAddr_.toIpPort(), err);
+        retry(sockfd);
+    } else if (Socket::isSelfConnect(sockfd)) {
+        LOG_WARN("Connector::handleWrite {} self connect", serverAddr_.toIpPort());
+        retry(sockfd);
+    } else {
+        setState(kConnected);
+        if (connect_) {
+            newConnectionCallback_(sockfd);
+        } else {
+            ::close(sockfd);
+        }
+    }
+}
+
+void Connector::handleError() {
+    if (state_ != kConnecting) {
+        return;
+    }
+    cancelTimer(&timeoutTimer_);
+    int sockfd = removeAndResetChannel();
+    LOG_WARN("Connector::handleError {} SO_ERROR = {}", serverAddr_.toIpPort(), Socket::getSocketError(sockfd));
+    retry(sockfd);
+}
+
+void Connector::handleTimeout() {
+    timeoutTimer_ = TimerId();
+    if (state_ != kConnecting) {
+        return;
+    }
+    LOG_WARN("Connector::handleTimeout {} connect timeout after {}s", serverAddr_.toIpPort(), connectTimeout_);
+    retry(removeAndResetChannel());
+}
+
+void Connector::retry(int sockfd) {
+    if (sockfd >= 0) {
+        ::close(sockfd);
+    }
+    setState(kDisconnected);
+    if (!connect_) {
+        return;
+    }
+    if (maxAttempts_ > 0 && attempts_ >= maxAttempts_) {
+        LOG_WARN("Connector::retry {} giving up after {} attempts", serverAddr_.toIpPort(), attempts_);
+        connect_ = false;
+        if (connectFailedCallback_) {
+            connectFailedCallback_();
+        }
+        return;
+    }
+    double delay = nextRetryDelay();
+    LOG_INFO("Connector::retry connecting to {} in {:.3f}s", serverAddr_.toIpPort(), delay);
+    std::weak_ptr<Connector> weak = shared_from_this();
+    retryTimer_ = loop_->runAfter(delay, [weak] {
+        if (auto self = weak.lock()) {
+            self->retryTimer_ = TimerId();
+            self->startInLoop();
+        }
+    });
+}
+
+double Connector::nextRetryDelay() {
+    std::uniform_real_distribution<double> jitter(retryDelay_ / 2, retryDelay_);
+    double delay = jitter(rng_);
+    retryDelay_ = std::min(retryDelay_ * 2, maxRetryDelay_);
+    return delay;
+}
+
+void Connector::cancelTimer(TimerId* timer) {
+    if (timer->valid()) {
+        loop_->cancel(*timer);
+        *timer = TimerId();
+    }
+}
@@ -1,7 +1,6 @@
 #include "EPollPoller.h"
 
 #include <errno.h>
-#include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -24,13 +23,13 @@ EPollPoller::~EPollPoller() {
     ::close(epollfd_);
 }
 
-Timestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels) {
+MonoTimestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels) {
     // 由于频繁调用poll 当遇到并发场景 关闭DEBUG日志提升效率
     int numEvents = ::epoll_wait(epollfd_, &*events_.begin(), static_cast<int>(events_.size()), timeoutMs);
     int saveErrno = errno;
-    Timestamp now(Timestamp::now());
+    MonoTimestamp now(MonoTimestamp::now());
     if (numEvents > 0) {
-        LOG_INFO("{} events happend", numEvents);
+        LOG_DEBUG("{} events happend", numEvents);
         fillActiveChannels(numEvents, activeChannels);
         if (numEvents == static_cast<int>(events_.size())) {
             events_.resize(events_.size() * 2);
@@ -55,37 +54,39 @@ Timestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels) {
 // ```
 void EPollPoller::updateChannel(Channel* channel) {
     const int index = channel->getIndex();
-    LOG_INFO(" => fd = {} events = {} index = {}", channel->getFd(), channel->getEvents(), index);
-
-    if (index == kNew || index == kDeleted) {  // channel还未在Poller中注册
-        if (index == kNew) {
-            int fd = channel->getFd();
-            channels_[fd] = channel;
-        } else {  // index == kDeleted
-            // 仅更新状态，无需操作channels_
+    const int fd = channel->getFd();
+    LOG_DEBUG(" => fd = {} events = {} index = {}", fd, channel->getEvents(), index);
+
+    ChannelSlot& slot = slotOf(fd);
+    if (index == kNew || index == kDeleted) {  // channel还未在epoll中注册
+        slot.channel = channel;
+        if (channel->isNoneEvent()) {  // 尚无关注事件，只登记不注册
+            channel->setIndex(kDeleted);
+            return;
         }
         channel->setIndex(kAdded);
-        update(EPOLL_CTL_ADD, channel);
-    } else {  // channel已经在Poller中注册过
+        update(EPOLL_CTL_ADD, channel, &slot);
+    } else {  // channel已经在epoll中注册过
         if (channel->isNoneEvent()) {  // 为空事件，删除该fd
-            update(EPOLL_CTL_DEL, channel);
+            update(EPOLL_CTL_DEL, channel, &slot);
             channel->setIndex(kDeleted);
-        } else {
-            update(EPOLL_CTL_MOD, channel);
+        } else if (interestOf(channel) != slot.registeredEvents) {
+            update(EPOLL_CTL_MOD, channel, &slot);
         }
+        // 掩码未变化（如重复 enableReading）时跳过 epoll_ctl
     }
 }
 
 void EPollPoller::removeChannel(Channel* channel) {
     int fd = channel->getFd();
-    channels_.erase(fd);
+    LOG_DEBUG("=> fd = {}", fd);
 
-    LOG_INFO("=> fd = {}", fd);
-    int index = channel->getIndex();
-    if (index == kAdded) {
-        update(EPOLL_CTL_DEL, channel);
+    ChannelSlot& slot = slotOf(fd);
+    if (channel->getIndex() == kAdded) {
+        update(EPOLL_CTL_DEL, channel, &slot);
     }
-    channel->setIndex(kDeleted);
+    slot = ChannelSlot{};
+    channel->setIndex(kNew);
 }
 
 // 将 epoll_wait 返回的就绪事件填充到 activeChannels 中，供 EventLoop 处理。
@@ -99,28 +100,28 @@ void EPollPoller::fillActiveChannels(int numEvents, ChannelList* activeChannels)
     }
 }
 
-void EPollPoller::update(int operation, Channel* channel) {
+uint32_t EPollPoller::interestOf(const Channel* channel) {
+    uint32_t events = static_cast<uint32_t>(channel->getEvents());
+    if (channel->isEdgeTriggered()) {
+        events |= EPOLLET;
+    }
+    return events;
+}
+
+// Channel的注册状态由 index_ 跟踪：fd 总是在 channel 注销之后才由其拥有者关闭，
+// 因此无需在每次 epoll_ctl 前用 fcntl 探测 fd 是否存活
+void EPollPoller::update(int operation, Channel* channel, ChannelSlot* slot) {
     epoll_event event{};
     int fd = channel->getFd();
 
-    event.events = channel->getEvents();
-    event.data.fd = fd;
+    event.events = interestOf(channel);
     event.data.ptr = channel;
 
-    LOG_INFO("epoll_ctl op={} fd={}", operation, fd);
-
-    // 1. 检查 fd 是否已被 close（避免 EBADF）
-    bool alive = (::fcntl(fd, F_GETFD) != -1 || errno != EBADF);
-
-    // 如果 fd 已经关闭且是 DEL/MOD 操作，就跳过 epoll_ctl
-    if (!alive && (operation == EPOLL_CTL_DEL || operation == EPOLL_CTL_MOD)) {
-        LOG_WARN("[EPollPoller] skip epoll_ctl(op={}, fd={}) because fd already closed", operation, fd);
-        return;
-    }
+    LOG_DEBUG("epoll_ctl op={} fd={}", operation, fd);
 
-    // 2. 正常执行 epoll_ctl
     if (::epoll_ctl(epollfd_, operation, fd, &event) < 0) {
-        // 如果是 DEL/MOD 且 errno=EBADF/ENOENT，则视为“幂等成功”
+        slot->registeredEvents = 0;  // 内核未收到该掩码，下次相同掩码的更新不能被当作冗余跳过
+        // 如果是 DEL/MOD 且 errno=EBADF/ENOENT（fd已被提前关闭），则视为“幂等成功”
         if ((operation == EPOLL_CTL_DEL || operation == EPOLL_CTL_MOD) &&
             (errno == EBADF || errno == ENOENT)) {
             LOG_WARN("[EPollPoller] ignore benign epoll_ctl(op={}, fd={}) errno={}", operation, fd, errno);
@@ -134,5 +135,7 @@ void EPollPoller::update(int operation, Channel* channel) {
         } else {
             LOG_ERROR("epoll_ctl add/mod error:{}", errno);
         }
+        return;
     }
+    slot->registeredEvents = operation == EPOLL_CTL_DEL ? 0 : event.events;
 }
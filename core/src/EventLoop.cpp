@@ -2,15 +2,22 @@
 
 #include <sys/eventfd.h>
 
+#include <algorithm>
+
 #include "Channel.h"
 #include "LogMacros.h"
 #include "Poller.h"
+#include "TimerQueue.h"
+#include "TimingWheel.h"
 
 // 每个线程对应一个 EventLoop
 thread_local EventLoop* t_loopInThisThread = nullptr;
 
 // 定义默认的Poller IO复用接口的超时时间
 const int kPollTime = 10000;  // 10000ms = 10s
+// 每轮事件循环最多执行的跨线程回调数，剩余部分留到下一轮，避免饿死IO事件
+const size_t kMaxPendingFunctors = 1024;
+
 
 /**
  * 创建一个eventfd用于线程间通信，无需加锁即可同步。
@@ -38,9 +45,20 @@ EventLoop::EventLoop() :
     quit_(false),
     threadId_(CurrentThread::tid()),
     poller_(Poller::newDefaultPoller(this)),
+    cachedNow_(MonoTimestamp::now()),
+    timerQueue_(std::make_unique<TimerQueue>(this)),
+    timingWheel_(std::make_unique<TimingWheel>(this)),
     wakeupFd_(createEventfd()),
     wakeupChannel_(new Channel(this, wakeupFd_)),
-    callingPendingFunctors_(false) {
+    callingPendingFunctors_(false),
+    wakeupPending_(false),
+    busyPollMaxMicros_(0),
+    spinBudgetMicros_(0),
+    spinMicros_(0),
+    sleepMicros_(0),
+    connectionCount_(0),
+    busyMicros_(0),
+    connectionSlab_(std::make_shared<SlabPool>()) {
     LOG_DEBUG("EvnetLoop created {} in thread {}", this, threadId_);
     if (t_loopInThisThread == nullptr) {
         t_loopInThisThread = this;
@@ -63,13 +81,24 @@ void EventLoop::loop() {
     quit_ = false;
     wakeup();  // 启动前先唤醒一次，确保poll不长阻塞
     LOG_INFO("EventLoop {} start looping", this);
+    MonoTimestamp iterationEnd = MonoTimestamp::now();
     while (!quit_) {
         activeChannels_.clear();
-        pollReturnTime_ = poller_->poll(kPollTime, &activeChannels_);
+        cachedNow_ = busyPollMaxMicros_ > 0 ? busyPoll() : poller_->poll(kPollTime, &activeChannels_);
+        pollReturnTime_ = wallTime(cachedNow_);
+        MonoTimestamp pollReturn = cachedNow_;
+        stats_.recordPoll(activeChannels_.size(), microsDifference(pollReturn, iterationEnd));
         for (Channel* channel : activeChannels_) {
             channel->handleEvent(pollReturnTime_);  // Poller 监听事件，上报给 EventLoop通知 channel处理相应事件
         }
-        doPendingFunctors();
+        MonoTimestamp handled = MonoTimestamp::now();
+        stats_.recordHandlers(microsDifference(handled, pollReturn));
+        cachedNow_ = handled;  // 跨线程回调看到的时间不含本轮IO处理耗时
+        iterationEnd = doPendingFunctors(handled);
+        // 本轮忙碌时长 = poll返回到回调执行完毕，EWMA平滑（新样本权重1/8）
+        int64_t busy = microsDifference(iterationEnd, pollReturn);
+        int64_t avg = busyMicros_.load(std::memory_order_relaxed);
+        busyMicros_.store(avg + (busy - avg) / 8, std::memory_order_relaxed);
     }
     LOG_INFO("EventLoop {} stop looping", this);
     looping_ = false;
@@ -91,11 +120,15 @@ void EventLoop::runInLoop(Functor&& cb) {
 }
 
 void EventLoop::queueInLoop(Functor&& cb) {
-    {
-        std::unique_lock<std::mutex> lock(mutex_);
-        pendingFunctors_.emplace_back(std::move(cb));
-    }
+    pendingFunctors_.push(std::move(cb));
+    // 入队完成后再检查唤醒标志：loop清除标志之后入队的任务必然会触发一次唤醒
     if (!isInLoopThread() || callingPendingFunctors_) {
+        wakeupIfNeeded();
+    }
+}
+
+void EventLoop::wakeupIfNeeded() {
+    if (!wakeupPending_.exchange(true, std::memory_order_acq_rel)) {
         wakeup();
     }
 }
@@ -108,6 +141,72 @@ void EventLoop::wakeup() {
     }
 }
 
+TimerId EventLoop::runAt(Timestamp time, TimerCallback cb) {
+    // 定时器按单调时钟排序：日历时间点换算为距现在的时长，之后的系统时间调整不再影响它
+    return runAfter(timeDifference(time, Timestamp::now()), std::move(cb));
+}
+
+TimerId EventLoop::runAt(MonoTimestamp time, TimerCallback cb) {
+    return timerQueue_->addTimer(std::move(cb), time, 0.0);
+}
+
+TimerId EventLoop::runAfter(double delay, TimerCallback cb) {
+    return runAt(addTime(MonoTimestamp::now(), delay), std::move(cb));
+}
+
+TimerId EventLoop::runEvery(double interval, TimerCallback cb) {
+    return timerQueue_->addTimer(std::move(cb), addTime(MonoTimestamp::now(), interval), interval);
+}
+
+void EventLoop::cancel(TimerId timerId) {
+    timerQueue_->cancel(timerId);
+}
+
+void EventLoop::setBusyPoll(int64_t maxSpinMicros) {
+    runInLoop([this, maxSpinMicros] {
+        busyPollMaxMicros_ = std::max<int64_t>(maxSpinMicros, 0);
+        spinBudgetMicros_ = busyPollMaxMicros_;
+    });
+}
+
+MonoTimestamp EventLoop::cachedNow() {
+    return t_loopInThisThread != nullptr ? t_loopInThisThread->cachedNow_ : MonoTimestamp::now();
+}
+
+Timestamp EventLoop::wallTime(MonoTimestamp mono) {
+    if (microsDifference(mono, wallBaseMono_) >= Timestamp::kMicroSecondsPerSecond) {
+        wallBase_ = Timestamp::now();
+        wallBaseMono_ = MonoTimestamp::now();
+    }
+    return Timestamp(wallBase_.getMicroSecondsSinceEpoch() + microsDifference(mono, wallBaseMono_));
+}
+
+MonoTimestamp EventLoop::busyPoll() {
+    // 自旋期间loop保持清醒并主动检查队列，置位唤醒标志使生产者跳过eventfd写入
+    wakeupPending_.store(true, std::memory_order_release);
+    MonoTimestamp start = MonoTimestamp::now();
+    MonoTimestamp now = start;
+    bool gotWork = false;
+    do {
+        now = poller_->poll(0, &activeChannels_);
+        gotWork = !activeChannels_.empty() || pendingFunctors_.hasPending() || quit_;
+    } while (!gotWork && microsDifference(now, start) < spinBudgetMicros_);
+    spinMicros_.fetch_add(microsDifference(now, start), std::memory_order_relaxed);
+
+    if (gotWork) {
+        spinBudgetMicros_ = std::min(spinBudgetMicros_ * 2, busyPollMaxMicros_);
+        return now;
+    }
+    spinBudgetMicros_ = std::max(spinBudgetMicros_ / 2, std::max<int64_t>(busyPollMaxMicros_ / 64, 1));
+
+    // 预算耗尽：先清除标志再确认一次队列，此后的投递都会写eventfd，不会丢失唤醒
+    wakeupPending_.exchange(false, std::memory_order_acq_rel);
+    int timeoutMs = pendingFunctors_.hasPending() ? 0 : kPollTime;
+    MonoTimestamp wake = poller_->poll(timeoutMs, &activeChannels_);
+    sleepMicros_.fetch_add(microsDifference(wake, now), std::memory_order_relaxed);
+    return wake;
+}
+
 void EventLoop::updateChannel(Channel* channel) {
     poller_->updateChannel(channel);
 }
@@ -120,6 +219,10 @@ bool EventLoop::hasChannel(Channel* channel) {
     return poller_->hasChannel(channel);
 }
 
+bool EventLoop::supportsEdgeTriggered() const {
+    return poller_->supportsEdgeTriggered();
+}
+
 void EventLoop::handleRead() {
     uint64_t one;
     ssize_t n = 0;
@@ -134,15 +237,26 @@ void EventLoop::handleRead() {
     }
 }
 
-void EventLoop::doPendingFunctors() {
-    std::vector<Functor> functors;
+MonoTimestamp EventLoop::doPendingFunctors(MonoTimestamp start) {
     callingPendingFunctors_ = true;
-    {
-        std::unique_lock<std::mutex> lock(mutex_);
-        functors.swap(pendingFunctors_);  // 交换的方式减少了锁的临界区范围 提升效率 同时避免了死锁 如果执行functor()在临界区内 且functor()中调用queueInLoop()就会产生死锁
-    }
-    for (const Functor& functor : functors) {
+    // 先清除唤醒标志再消费：与生产者的exchange构成acq_rel同步，保证看到其已链接的节点
+    wakeupPending_.exchange(false, std::memory_order_acq_rel);
+    pendingFunctors_.beginBatch();  // 本轮回调中新入队的任务留到下一轮执行
+    Functor functor;
+    size_t count = 0;
+    while (count < kMaxPendingFunctors && pendingFunctors_.pop(&functor)) {
         functor();  // 执行回调
+        ++count;
+    }
+    bool deferred = pendingFunctors_.hasPending();
+    if (deferred) {
+        wakeupIfNeeded();  // 未执行完（超出批量上限或本轮新入队），保证下一轮poll立即返回
     }
     callingPendingFunctors_ = false;
+    if (count == 0) {
+        return start;  // 空队列不再读时钟
+    }
+    MonoTimestamp end = MonoTimestamp::now();
+    stats_.recordFunctors(count, microsDifference(end, start), deferred);
+    return end;
 }
\ No newline at end of file
@@ -25,7 +25,7 @@ EventLoop* EventLoopThread::startLoop() {
 }
 
 void EventLoopThread::threadFunc() {
-    EventLoop loop;  // 创建独立的对象和线程一一对应， One Loop One Thread
+    EventLoop loop;  // 创建独立的对象和线程一一对应， One Loop One Thread（线程已绑核，Poller等结构first-touch在本地节点）
     if (callback_) {
         callback_(&loop);
     }
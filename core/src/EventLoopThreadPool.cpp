@@ -1,7 +1,15 @@
 #include "EventLoopThreadPool.h"
 
+#include "EventLoop.h"
 #include "EventLoopThread.h"
-EventLoopThreadPool::EventLoopThreadPool(EventLoop* baseLoop, const std::string& nameArg) : baseLoop_(baseLoop), name_(nameArg), started_(false), numThreads_(0), next_(0) {}
+EventLoopThreadPool::EventLoopThreadPool(EventLoop* baseLoop, const std::string& nameArg) :
+    baseLoop_(baseLoop),
+    name_(nameArg),
+    started_(false),
+    numThreads_(0),
+    next_(0),
+    policy_(kRoundRobin),
+    rng_(std::random_device{}()) {}
 
 EventLoopThreadPool::~EventLoopThreadPool() {
     // 不删除循环，因为这里是栈区变量
@@ -16,25 +24,91 @@ void EventLoopThreadPool::start(const ThreadInitCallback& cb) {
     for (int i = 0; i < numThreads_; ++i) {
         std::string threadName = name_ + std::to_string(i + 1);
         EventLoopThread* t = new EventLoopThread(cb, threadName);
+        if (!cpus_.empty()) {
+            t->setCpuAffinity({cpuOf(static_cast<size_t>(i))});
+        }
         threads_.push_back(std::unique_ptr<EventLoopThread>(t));
         loops_.push_back(t->startLoop());
     }
 }
 
-// 如果工作在多线程中，baseLoop_(mainLoop)会默认以轮询的方式分配Channel给subLoop
+// 如果工作在多线程中，baseLoop_(mainLoop)按分配策略（默认轮询）分配Channel给subLoop
 EventLoop* EventLoopThreadPool::getNextLoop() {
     // 单线程， mainReactor 存在，subReactor 不存在
-    EventLoop* loop = baseLoop_;
-    if (!loops_.empty()) {
-        loop = loops_[next_];
-        ++next_;
-        if (next_ >= loops_.size()) {
-            next_ = 0;
-        }
+    if (loops_.empty()) {
+        return baseLoop_;
+    }
+    if (placementFunction_) {
+        EventLoop* loop = placementFunction_(loops_);
+        return loop != nullptr ? loop : roundRobin();
+    }
+    switch (policy_) {
+        case kLeastConnections:
+            return leastConnections();
+        case kLeastLatency:
+            return leastLatency();
+        case kPowerOfTwoChoices:
+            return powerOfTwoChoices();
+        case kRoundRobin:
+        default:
+            return roundRobin();
+    }
+}
+
+EventLoop* EventLoopThreadPool::roundRobin() {
+    EventLoop* loop = loops_[next_];
+    ++next_;
+    if (next_ >= loops_.size()) {
+        next_ = 0;
     }
     return loop;
 }
 
+// 从轮询位置开始扫描，计数相同时各loop轮流胜出，避免总是压到第一个
+EventLoop* EventLoopThreadPool::leastConnections() {
+    size_t start = next_;
+    next_ = (next_ + 1) % loops_.size();
+    EventLoop* best = loops_[start];
+    for (size_t i = 1; i < loops_.size(); ++i) {
+        EventLoop* loop = loops_[(start + i) % loops_.size()];
+        if (loop->connectionCount() < best->connectionCount()) {
+            best = loop;
+        }
+    }
+    return best;
+}
+
+// 耗时相同（如都空闲）时按连接数比较
+EventLoop* EventLoopThreadPool::leastLatency() {
+    size_t start = next_;
+    next_ = (next_ + 1) % loops_.size();
+    EventLoop* best = loops_[start];
+    for (size_t i = 1; i < loops_.size(); ++i) {
+        EventLoop* loop = loops_[(start + i) % loops_.size()];
+        if (loop->busyMicros() < best->busyMicros() ||
+            (loop->busyMicros() == best->busyMicros() && loop->connectionCount() < best->connectionCount())) {
+            best = loop;
+        }
+    }
+    return best;
+}
+
+// power of two choices：只读两个loop的计数，负载均衡效果接近全局最小且无需扫描
+EventLoop* EventLoopThreadPool::powerOfTwoChoices() {
+    if (loops_.size() == 1) {
+        return loops_[0];
+    }
+    std::uniform_int_distribution<size_t> dist(0, loops_.size() - 1);
+    size_t a = dist(rng_);
+    size_t b = dist(rng_);
+    while (b == a) {
+        b = dist(rng_);
+    }
+    EventLoop* first = loops_[a];
+    EventLoop* second = loops_[b];
+    return second->connectionCount() < first->connectionCount() ? second : first;
+}
+
 std::vector<EventLoop*> EventLoopThreadPool::getAllLoops() {
     std::vector<EventLoop*> all = loops_;
     if (loops_.empty()) {
@@ -42,3 +116,19 @@ std::vector<EventLoop*> EventLoopThreadPool::getAllLoops() {
     }
     return all;
 }
+
+std::vector<LoopStats> EventLoopThreadPool::getAllStats() {
+    std::vector<LoopStats> stats;
+    for (EventLoop* loop : getAllLoops()) {
+        stats.push_back(loop->stats());
+    }
+    return stats;
+}
+
+LoopStats EventLoopThreadPool::aggregateStats() {
+    LoopStats total;
+    for (EventLoop* loop : getAllLoops()) {
+        total += loop->stats();
+    }
+    return total;
+}
@@ -0,0 +1,252 @@
+#include "HotRestart.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <cmath>
+
+#include "Acceptor.h"
+#include "Channel.h"
+#include "EventLoop.h"
+#include "LogMacros.h"
+#include "Socket.h"
+
+namespace {
+const char kConfirm = 'R';  // 新进程已开始服务，旧进程可以排空
+const double kMinReceiveTimeout = 0.001;  // SO_RCVTIMEO 为0表示永久阻塞，超时不得低于1毫秒
+
+void closeAll(const std::vector<int>& fds) {
+    for (int fd : fds) {
+        ::close(fd);
+    }
+}
+}  // namespace
+
+HotRestart::HotRestart(EventLoop* loop, const InetAddress& controlAddr) : loop_(loop), controlAddr_(controlAddr), takenOver_(false) {}
+
+HotRestart::~HotRestart() {
+    if (peerChannel_) {
+        peerChannel_->disableAll();
+        peerChannel_->remove();
+    }
+}
+
+void HotRestart::start() {
+    if (!controlAddr_.isUnix()) {
+        LOG_ERROR("HotRestart control address {} is not a unix socket", controlAddr_.toIpPort());
+        return;
+    }
+    listen();
+}
+
+void HotRestart::listen() {
+    acceptor_ = std::make_shared<Acceptor>(loop_, controlAddr_, false);
+    acceptor_->setNewConnectionCallback([this](int sockfd, const InetAddress&) { handleNewPeer(sockfd); });
+    // 文件路径在 listen 之前收紧为仅属主可连接，bind 与 chmod 之间的连接尝试因尚未监听而被拒绝
+    if (!controlAddr_.isAbstract() && ::chmod(controlAddr_.toIp().c_str(), S_IRUSR | S_IWUSR) != 0) {
+        LOG_ERROR("HotRestart chmod {} err:{}", controlAddr_.toIpPort(), errno);
+    }
+    acceptor_->listen();
+    LOG_INFO("HotRestart waiting for takeover on {}", controlAddr_.toIpPort());
+}
+
+void HotRestart::handleNewPeer(int sockfd) {
+    if (peer_ || takenOver_) {
+        ::close(sockfd);  // 同一时间只交接给一个新进程
+        return;
+    }
+    // 监听fd交出后对端可以抢占端口并让本进程排空退出，只交给同一有效uid的进程
+    ucred cred{};
+    socklen_t len = sizeof cred;
+    if (::getsockopt(sockfd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 || cred.uid != ::geteuid()) {
+        LOG_WARN("HotRestart reject peer pid:{} uid:{} on {}", cred.pid, cred.uid, controlAddr_.toIpPort());
+        ::close(sockfd);
+        return;
+    }
+    peer_ = std::make_unique<Socket>(sockfd);
+    // 控制监听须在 Acceptor::handleRead 返回后关闭；先关闭再发fd，新进程收到fd时控制地址已可重新绑定
+    loop_->queueInLoop([self = shared_from_this()] {
+        self->acceptor_.reset();
+        self->sendFds();
+    });
+}
+
+void HotRestart::sendFds() {
+    std::vector<int> fds = fdsProvider_ ? fdsProvider_() : std::vector<int>();
+    if (fds.empty() || fds.size() > kMaxFds) {
+        LOG_ERROR("HotRestart has {} listen fds to hand over, abort", fds.size());
+        closePeer();
+        listen();
+        return;
+    }
+
+    // 负载为fd个数，fd本身随 SCM_RIGHTS 控制消息传递，内核在接收方复制出新的fd
+    auto count = static_cast<uint32_t>(fds.size());
+    iovec iov = {&count, sizeof count};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+    msghdr msg;
+    ::memset(&msg, 0, sizeof msg);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    ::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    if (::sendmsg(peer_->getSocketFd(), &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof count)) {
+        LOG_ERROR("HotRestart sendmsg listen fds err:{}", errno);
+        closePeer();
+        listen();
+        return;
+    }
+    LOG_INFO("HotRestart handed over {} listen fds, waiting for confirmation", fds.size());
+
+    peerChannel_ = std::make_unique<Channel>(loop_, peer_->getSocketFd());
+    peerChannel_->setReadCallback([this](Timestamp) { handlePeerRead(); });
+    peerChannel_->setCloseCallback([this] { handlePeerRead(); });
+    peerChannel_->setErrorCallback([this] { handlePeerRead(); });
+    peerChannel_->enableReading();
+}
+
+void HotRestart::handlePeerRead() {
+    char ack = 0;
+    ssize_t n = ::read(peer_->getSocketFd(), &ack, sizeof ack);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    closePeer();
+    if (n == 1 && ack == kConfirm) {
+        takenOver_ = true;
+        LOG_INFO("HotRestart takeover confirmed, new process is serving");
+        if (takeoverCallback_) {
+            takeoverCallback_();
+        }
+    } else {
+        // 新进程启动失败：fd仍由本进程持有并继续accept，重新等待下一次交接
+        LOG_WARN("HotRestart new process left without confirming, keep serving");
+        listen();
+    }
+}
+
+void HotRestart::closePeer() {
+    if (peerChannel_) {
+        peerChannel_->disableAll();
+        peerChannel_->remove();
+    }
+    // 可能正处于 Channel::handleEvent 中，不能在此销毁 Channel
+    loop_->queueInLoop([channel = std::shared_ptr<Channel>(std::move(peerChannel_)), peer = std::shared_ptr<Socket>(std::move(peer_))] {});
+}
+
+std::vector<int> HotRestart::receiveListenFds(const InetAddress& controlAddr, double timeoutSeconds, int* controlFd) {
+    *controlFd = -1;
+    int sockfd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sockfd < 0) {
+        LOG_ERROR("HotRestart socket create err:{}", errno);
+        return {};
+    }
+    if (::connect(sockfd, controlAddr.getSockAddr(), controlAddr.getSockLen()) < 0) {
+        if (errno == ENOENT || errno == ECONNREFUSED) {
+            LOG_INFO("HotRestart no running process on {}, cold start", controlAddr.toIpPort());
+        } else {
+            LOG_ERROR("HotRestart connect {} err:{}", controlAddr.toIpPort(), errno);
+        }
+        ::close(sockfd);
+        return {};
+    }
+    if (!(timeoutSeconds >= kMinReceiveTimeout)) {  // 同时拒绝 NaN
+        LOG_WARN("HotRestart receive timeout {}s too small, use {}s", timeoutSeconds, kMinReceiveTimeout);
+        timeoutSeconds = kMinReceiveTimeout;
+    }
+    double whole = 0.0;
+    double frac = std::modf(timeoutSeconds, &whole);
+    timeval tv = {static_cast<time_t>(whole), static_cast<suseconds_t>(frac * 1e6)};
+    ::setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+
+    uint32_t count = 0;
+    iovec iov = {&count, sizeof count};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * kMaxFds));
+    msghdr msg;
+    ::memset(&msg, 0, sizeof msg);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    ssize_t n = ::recvmsg(sockfd, &msg, MSG_CMSG_CLOEXEC);
+
+    std::vector<int> fds;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); n > 0 && cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            size_t num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const auto* data = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+            fds.insert(fds.end(), data, data + num);
+        }
+    }
+    if (n != static_cast<ssize_t>(sizeof count) || fds.size() != count || (msg.msg_flags & MSG_CTRUNC)) {
+        LOG_ERROR("HotRestart receive listen fds from {} failed: n={} fds={}/{} err:{}", controlAddr.toIpPort(), n, fds.size(), count, errno);
+        closeAll(fds);
+        ::close(sockfd);
+        return {};
+    }
+    LOG_INFO("HotRestart received {} listen fds from {}", fds.size(), controlAddr.toIpPort());
+    *controlFd = sockfd;
+    return fds;
+}
+
+void HotRestart::confirmTakeover(int controlFd) {
+    if (::write(controlFd, &kConfirm, sizeof kConfirm) != sizeof kConfirm) {
+        LOG_ERROR("HotRestart confirm takeover err:{}", errno);
+    }
+    ::close(controlFd);
+}
+
+bool HotRestart::exportListenFds(const std::vector<int>& fds, const std::string& envName) {
+    std::string value;
+    for (int fd : fds) {
+        int flags = ::fcntl(fd, F_GETFD);
+        if (flags < 0 || ::fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC) < 0) {
+            LOG_ERROR("HotRestart clear FD_CLOEXEC fd:{} err:{}", fd, errno);
+            return false;
+        }
+        if (!value.empty()) {
+            value += ',';
+        }
+        value += std::to_string(fd);
+    }
+    return ::setenv(envName.c_str(), value.c_str(), 1) == 0;
+}
+
+std::vector<int> HotRestart::listenFdsFromEnv(const std::string& envName) {
+    const char* value = ::getenv(envName.c_str());
+    if (value == nullptr) {
+        return {};
+    }
+    std::vector<int> fds;
+    const char* end = value + ::strlen(value);
+    for (const char* p = value; p < end;) {
+        int fd = -1;
+        auto [next, ec] = std::from_chars(p, end, fd);
+        if (ec != std::errc() || fd < 0 || ::fcntl(fd, F_GETFD) < 0) {
+            LOG_ERROR("HotRestart invalid {}={}", envName, value);
+            return {};
+        }
+        fds.push_back(fd);
+        p = (next < end && *next == ',') ? next + 1 : next;
+        if (p == next && p < end) {
+            LOG_ERROR("HotRestart invalid {}={}", envName, value);
+            return {};
+        }
+    }
+    ::unsetenv(envName.c_str());  // 避免再传给本进程启动的子进程
+    return fds;
+}
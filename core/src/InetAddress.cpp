@@ -1,29 +1,189 @@
 #include "InetAddress.h"
 
+#include <stddef.h>
 #include <string.h>
+
+#include <algorithm>
+#include <charconv>
+
+#include "LogMacros.h"
+
+namespace {
+const socklen_t kUnixPathOffset = offsetof(sockaddr_un, sun_path);
+const size_t kMaxUnixPath = sizeof(sockaddr_un::sun_path) - 1;  // 文件路径需保留结尾'\0'；抽象名字占用首字节'\0'
+
+bool parsePort(const std::string& text, uint16_t* port) {
+    unsigned value = 0;
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (text.empty() || ec != std::errc() || ptr != end || value > 65535) {
+        return false;
+    }
+    *port = static_cast<uint16_t>(value);
+    return true;
+}
+}  // namespace
+
 InetAddress::InetAddress(std::string ip, uint16_t port) {
     ::memset(&addr_, 0, sizeof(addr_));
-    addr_.sin_family = AF_INET;  // IPV4
-    addr_.sin_port = ::htons(port);  // 本地字节序转化为网络字节序
-    addr_.sin_addr.s_addr = ::inet_addr(ip.c_str());
+    if (ip.find(':') != std::string::npos) {
+        addr_.in6.sin6_family = AF_INET6;
+        addr_.in6.sin6_port = ::htons(port);
+        if (::inet_pton(AF_INET6, ip.c_str(), &addr_.in6.sin6_addr) != 1) {
+            LOG_ERROR("InetAddress invalid ipv6 address: {}", ip);
+        }
+        len_ = sizeof(sockaddr_in6);
+        return;
+    }
+    addr_.in.sin_family = AF_INET;  // IPV4
+    addr_.in.sin_port = ::htons(port);  // 本地字节序转化为网络字节序
+    addr_.in.sin_addr.s_addr = ::inet_addr(ip.c_str());
+    len_ = sizeof(sockaddr_in);
+}
+
+InetAddress::InetAddress(const sockaddr_in& addr) {
+    ::memset(&addr_, 0, sizeof(addr_));
+    addr_.in = addr;
+    len_ = sizeof(sockaddr_in);
+}
+
+InetAddress::InetAddress(const sockaddr_in6& addr) {
+    ::memset(&addr_, 0, sizeof(addr_));
+    addr_.in6 = addr;
+    len_ = sizeof(sockaddr_in6);
+}
+
+InetAddress InetAddress::unixPath(const std::string& path) {
+    if (path.empty() || path.size() > kMaxUnixPath) {
+        LOG_FATAL("InetAddress invalid unix socket path: {}", path);
+    }
+    sockaddr_un addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    ::memcpy(addr.sun_path, path.data(), path.size());
+    return InetAddress(reinterpret_cast<const sockaddr*>(&addr), static_cast<socklen_t>(kUnixPathOffset + path.size() + 1));
+}
+
+InetAddress InetAddress::abstractUnix(const std::string& name) {
+    if (name.size() > kMaxUnixPath) {
+        LOG_FATAL("InetAddress abstract unix socket name too long: {}", name);
+    }
+    sockaddr_un addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    ::memcpy(addr.sun_path + 1, name.data(), name.size());  // sun_path[0] = '\0' 表示抽象命名空间，名字按长度而非'\0'结尾
+    return InetAddress(reinterpret_cast<const sockaddr*>(&addr), static_cast<socklen_t>(kUnixPathOffset + 1 + name.size()));
+}
+
+bool InetAddress::parse(const std::string& spec, InetAddress* out) {
+    static const std::string kUnixPrefix = "unix:";
+    if (spec.starts_with(kUnixPrefix)) {
+        std::string path = spec.substr(kUnixPrefix.size());
+        bool abstract = path.starts_with('@');
+        if (abstract) {
+            path.erase(0, 1);
+        }
+        if (path.empty() || path.size() > kMaxUnixPath) {
+            return false;
+        }
+        *out = abstract ? abstractUnix(path) : unixPath(path);
+        return true;
+    }
+
+    std::string ip;
+    std::string port;
+    if (spec.starts_with('[')) {
+        size_t close = spec.find("]:");
+        if (close == std::string::npos) {
+            return false;
+        }
+        ip = spec.substr(1, close - 1);
+        port = spec.substr(close + 2);
+    } else {
+        size_t colon = spec.rfind(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        ip = spec.substr(0, colon);
+        port = spec.substr(colon + 1);
+        if (ip.find(':') != std::string::npos) {
+            return false;  // IPv6 须写成 [addr]:port
+        }
+    }
+
+    uint16_t portNum = 0;
+    char buf[sizeof(in6_addr)];
+    int family = spec.starts_with('[') ? AF_INET6 : AF_INET;
+    if (!parsePort(port, &portNum) || ::inet_pton(family, ip.c_str(), buf) != 1) {
+        return false;
+    }
+    *out = InetAddress(ip, portNum);
+    return true;
+}
+
+void InetAddress::setSockAddr(const sockaddr* addr, socklen_t len) {
+    ::memset(&addr_, 0, sizeof(addr_));
+    len_ = std::min<socklen_t>(len, sizeof(addr_));
+    ::memcpy(&addr_, addr, len_);
+}
+
+bool InetAddress::isAbstract() const {
+    return isUnix() && len_ > kUnixPathOffset && addr_.un.sun_path[0] == '\0';
 }
 
 std::string InetAddress::toIp() const {
-    char buf[64] = {0};
-    ::inet_ntop(AF_INET, &addr_.sin_addr, buf, sizeof buf);
+    if (isUnix()) {
+        if (len_ <= kUnixPathOffset) {
+            return "";  // 未绑定地址的对端（如客户端 connect 前未 bind）
+        }
+        size_t pathLen = len_ - kUnixPathOffset;
+        if (addr_.un.sun_path[0] == '\0') {
+            return "@" + std::string(addr_.un.sun_path + 1, pathLen - 1);
+        }
+        return std::string(addr_.un.sun_path, ::strnlen(addr_.un.sun_path, pathLen));
+    }
+    char buf[INET6_ADDRSTRLEN] = {0};
+    if (isIpv6()) {
+        ::inet_ntop(AF_INET6, &addr_.in6.sin6_addr, buf, sizeof buf);
+    } else {
+        ::inet_ntop(AF_INET, &addr_.in.sin_addr, buf, sizeof buf);
+    }
     return buf;
 }
 
 std::string InetAddress::toIpPort() const {
-    // ip:port
-    char buf[64] = {0};
-    ::inet_ntop(AF_INET, &addr_.sin_addr, buf, sizeof buf);
-    size_t end = ::strlen(buf);
-    uint16_t port = ::ntohs(addr_.sin_port);
-    sprintf(buf + end, ":%u", port);
-    return buf;
+    if (isUnix()) {
+        return "unix:" + toIp();
+    }
+    // ip:port，IPv6 为 [ip]:port
+    std::string port = ":" + std::to_string(toPort());
+    return isIpv6() ? "[" + toIp() + "]" + port : toIp() + port;
 }
 
 uint16_t InetAddress::toPort() const {
-    return ::ntohs(addr_.sin_port);
+    switch (family()) {
+        case AF_INET:
+            return ::ntohs(addr_.in.sin_port);
+        case AF_INET6:
+            return ::ntohs(addr_.in6.sin6_port);
+        default:
+            return 0;
+    }
+}
+
+bool InetAddress::operator==(const InetAddress& other) const {
+    if (family() != other.family()) {
+        return false;
+    }
+    switch (family()) {
+        case AF_INET:
+            return addr_.in.sin_port == other.addr_.in.sin_port && addr_.in.sin_addr.s_addr == other.addr_.in.sin_addr.s_addr;
+        case AF_INET6:
+            return addr_.in6.sin6_port == other.addr_.in6.sin6_port && addr_.in6.sin6_scope_id == other.addr_.in6.sin6_scope_id &&
+                   ::memcmp(&addr_.in6.sin6_addr, &other.addr_.in6.sin6_addr, sizeof(in6_addr)) == 0;
+        case AF_UNIX:
+            return toIp() == other.toIp();  // 文件路径的长度可能含或不含结尾'\0'
+        default:
+            return len_ == other.len_ && ::memcmp(&addr_, &other.addr_, len_) == 0;
+    }
 }
@@ -0,0 +1,369 @@
+#include "IoUringPoller.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "Channel.h"
+#include "LogMacros.h"
+
+namespace {
+enum {
+    kNew = -1,  // 与 EPollPoller 相同：未添加至Poller
+    kAdded = 1  // 已添加
+};
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, size_t argSize) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+// 内核与用户态共享的环形队列索引需要 acquire/release 语义
+unsigned loadAcquire(unsigned* p) {
+    return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned* p, unsigned v) {
+    std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+}
+
+template <typename T>
+T* ringAt(void* base, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+}  // namespace
+
+IoUringPoller::IoUringPoller(EventLoop* loop, bool sqpoll) :
+    Poller(loop),
+    ringFd_(-1),
+    sqpoll_(sqpoll),
+    sqRing_(MAP_FAILED),
+    sqRingSize_(0),
+    cqRing_(MAP_FAILED),
+    cqRingSize_(0),
+    sqes_(nullptr),
+    sqesSize_(0),
+    sqHead_(nullptr),
+    sqTail_(nullptr),
+    sqMask_(nullptr),
+    sqFlags_(nullptr),
+    sqArray_(nullptr),
+    sqEntries_(0),
+    cqHead_(nullptr),
+    cqTail_(nullptr),
+    cqMask_(nullptr),
+    cqes_(nullptr),
+    pendingSubmits_(0),
+    nextGeneration_(0),
+    round_(0) {
+    if (!setupRing(sqpoll)) {
+        if (ringFd_ >= 0) {
+            ::close(ringFd_);
+            ringFd_ = -1;
+        }
+    }
+}
+
+IoUringPoller::~IoUringPoller() {
+    if (sqes_ != nullptr) {
+        ::munmap(sqes_, sqesSize_);
+    }
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        ::munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_ != MAP_FAILED) {
+        ::munmap(sqRing_, sqRingSize_);
+    }
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+    }
+}
+
+bool IoUringPoller::setupRing(bool sqpoll) {
+    io_uring_params params;
+    ::memset(&params, 0, sizeof params);
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = kRingEntries * 4;  // 完成队列放大，避免大量fd同时就绪时溢出
+    if (sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = 1000;  // 内核轮询线程空闲1s后休眠
+    }
+
+    ringFd_ = ioUringSetup(kRingEntries, &params);
+    if (ringFd_ < 0) {
+        LOG_WARN("io_uring_setup error:{}", errno);
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)) {
+        LOG_WARN("io_uring lacks EXT_ARG/NODROP support (features={})", params.features);
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        LOG_WARN("io_uring mmap sq ring error:{}", errno);
+        return false;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            LOG_WARN("io_uring mmap cq ring error:{}", errno);
+            return false;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_WARN("io_uring mmap sqes error:{}", errno);
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sqHead_ = ringAt<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = ringAt<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = ringAt<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqFlags_ = ringAt<unsigned>(sqRing_, params.sq_off.flags);
+    sqArray_ = ringAt<unsigned>(sqRing_, params.sq_off.array);
+    sqEntries_ = params.sq_entries;
+    cqHead_ = ringAt<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = ringAt<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = ringAt<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = ringAt<io_uring_cqe>(cqRing_, params.cq_off.cqes);
+
+    LOG_INFO("io_uring poller created fd={} sq={} cq={} sqpoll={}", ringFd_, params.sq_entries, params.cq_entries, sqpoll);
+    return true;
+}
+
+io_uring_sqe* IoUringPoller::getSqe() {
+    unsigned tail = *sqTail_;
+    if (tail - loadAcquire(sqHead_) >= sqEntries_) {
+        if (sqpoll_) {
+            // SQPOLL 模式下只能等内核线程消费：必要时唤醒它，并阻塞到SQ有空位
+            pendingSubmits_ = 0;
+            ioUringEnter(ringFd_, 0, 0, IORING_ENTER_SQ_WAKEUP | IORING_ENTER_SQ_WAIT, nullptr, 0);
+        } else {
+            submitAndWait(0, 0);  // 提交队列已满，先把积压的请求交给内核
+        }
+        if (tail - loadAcquire(sqHead_) >= sqEntries_) {
+            LOG_ERROR("io_uring submission queue full");
+            return nullptr;
+        }
+    }
+    unsigned index = tail & *sqMask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    ::memset(sqe, 0, sizeof *sqe);
+    sqArray_[index] = index;
+    return sqe;
+}
+
+void IoUringPoller::commitSqe() {
+    // SQE 写完后才移动tail：SQPOLL 内核线程随时可能消费tail之前的条目
+    storeRelease(sqTail_, *sqTail_ + 1);
+    ++pendingSubmits_;
+}
+
+int IoUringPoller::submitAndWait(unsigned waitNr, int timeoutMs) {
+    unsigned flags = 0;
+    unsigned toSubmit = pendingSubmits_;
+    if (sqpoll_) {
+        // SQPOLL 模式下由内核线程消费SQ，只有其休眠时才需要唤醒
+        toSubmit = 0;
+        if (pendingSubmits_ > 0 && (std::atomic_ref<unsigned>(*sqFlags_).load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP)) {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        }
+    }
+    pendingSubmits_ = 0;
+    if (waitNr == 0 && toSubmit == 0 && flags == 0) {
+        return 0;
+    }
+
+    struct __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    ::memset(&arg, 0, sizeof arg);
+    if (waitNr > 0) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        arg.sigmask_sz = _NSIG / 8;
+        if (timeoutMs >= 0) {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000 * 1000;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+    }
+    return ioUringEnter(ringFd_, toSubmit, waitNr, flags, waitNr > 0 ? &arg : nullptr, waitNr > 0 ? sizeof arg : 0);
+}
+
+MonoTimestamp IoUringPoller::poll(int timeoutMs, ChannelList* activeChannels) {
+    rearmReadyChannels();
+    // 若CQ中已有完成事件或仍有fd待重新挂载则不阻塞，仅提交积压的SQE
+    bool hasCqe = loadAcquire(cqTail_) != *cqHead_;
+    int ret = submitAndWait(hasCqe || !retryFds_.empty() ? 0 : 1, timeoutMs);
+    int saveErrno = errno;
+    MonoTimestamp now(MonoTimestamp::now());
+    if (ret < 0 && saveErrno != ETIME && saveErrno != EINTR) {
+        LOG_ERROR("IoUringPoller::poll() io_uring_enter error:{}", saveErrno);
+    }
+    fillActiveChannels(activeChannels);
+    if (activeChannels->empty()) {
+        LOG_DEBUG("timeout");
+    }
+    return now;
+}
+
+void IoUringPoller::fillActiveChannels(ChannelList* activeChannels) {
+    ++round_;
+
+    unsigned head = *cqHead_;
+    unsigned tail = loadAcquire(cqTail_);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+        if (cqe.user_data == kInternalUserData) {
+            continue;
+        }
+        int fd = static_cast<int>(cqe.user_data >> 32);
+        uint32_t generation = static_cast<uint32_t>(cqe.user_data);
+        PollState* found = findState(fd);
+        if (found == nullptr || !found->armed || found->generation != generation) {
+            continue;  // 已注销或已更新的旧请求
+        }
+        PollState& state = *found;
+        uint32_t revents = static_cast<uint32_t>(cqe.res);
+        if (cqe.res < 0) {
+            // 与 epoll 一致，以 EPOLLERR 交给 Channel 处理（由 handleError/handleClose 决定关闭），而不是静默丢弃
+            LOG_ERROR("io_uring poll fd={} error:{}", fd, -cqe.res);
+            revents = EPOLLERR;
+        }
+        if (state.round != round_) {
+            state.round = round_;
+            state.revents = 0;
+            readyFds_.push_back(fd);
+        }
+        state.revents |= revents;
+        state.armed = false;  // 单次 poll 已完成，事件处理后在下一轮重新挂载
+    }
+    storeRelease(cqHead_, head);
+
+    for (int fd : readyFds_) {
+        PollState& state = states_[static_cast<size_t>(fd)];
+        state.channel->setRevents(static_cast<int>(state.revents));
+        activeChannels->push_back(state.channel);
+    }
+}
+
+void IoUringPoller::rearmReadyChannels() {
+    std::vector<int> retries;
+    retries.swap(retryFds_);
+    for (int fd : retries) {
+        PollState* state = findState(fd);
+        if (state != nullptr && !state->armed && state->events != 0) {
+            queuePollAdd(fd, *state);
+        }
+    }
+    for (int fd : readyFds_) {
+        PollState* state = findState(fd);
+        // 已被注销、已由 updateChannel 重新挂载或不再关注任何事件的fd跳过
+        if (state == nullptr || state->armed || state->events == 0) {
+            continue;
+        }
+        queuePollAdd(fd, *state);
+    }
+    readyFds_.clear();
+}
+
+IoUringPoller::PollState* IoUringPoller::findState(int fd) {
+    size_t index = static_cast<size_t>(fd);
+    if (index >= states_.size() || states_[index].channel == nullptr) {
+        return nullptr;
+    }
+    return &states_[index];
+}
+
+void IoUringPoller::queuePollAdd(int fd, PollState& state) {
+    io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) {
+        state.armed = false;
+        retryFds_.push_back(fd);  // SQ 已满：下一轮 poll 前重试，不能就此丢掉该fd
+        return;
+    }
+    state.generation = ++nextGeneration_;
+    state.armed = true;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = state.events;
+    sqe->user_data = makeUserData(fd, state.generation);
+    commitSqe();
+}
+
+void IoUringPoller::queuePollRemove(int fd, const PollState& state) {
+    io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = makeUserData(fd, state.generation);
+    sqe->user_data = kInternalUserData;
+    commitSqe();
+}
+
+void IoUringPoller::updateChannel(Channel* channel) {
+    int fd = channel->getFd();
+    LOG_DEBUG(" => fd = {} events = {} index = {}", fd, channel->getEvents(), channel->getIndex());
+
+    slotOf(fd).channel = channel;
+    channel->setIndex(kAdded);
+    if (static_cast<size_t>(fd) >= states_.size()) {
+        states_.resize(std::max(static_cast<size_t>(fd) + 1, states_.size() * 2));
+    }
+    PollState& state = states_[static_cast<size_t>(fd)];
+    state.channel = channel;
+    uint32_t events = static_cast<uint32_t>(channel->getEvents());
+
+    if (channel->isNoneEvent()) {
+        if (state.armed) {
+            queuePollRemove(fd, state);
+            state.armed = false;
+        }
+        state.events = 0;
+    } else if (!state.armed) {
+        state.events = events;
+        queuePollAdd(fd, state);
+    } else if (state.events != events) {
+        // 先撤销旧请求再以新代号注册，旧请求的迟到CQE会因代号不符被丢弃
+        queuePollRemove(fd, state);
+        state.events = events;
+        queuePollAdd(fd, state);
+    }
+}
+
+void IoUringPoller::removeChannel(Channel* channel) {
+    int fd = channel->getFd();
+    LOG_DEBUG("=> fd = {}", fd);
+    if (PollState* state = findState(fd)) {
+        if (state->armed) {
+            queuePollRemove(fd, *state);
+        }
+        *state = PollState{};
+    }
+    slotOf(fd) = ChannelSlot{};
+    channel->setIndex(kNew);
+}
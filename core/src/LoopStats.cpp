@@ -0,0 +1,113 @@
+#include "LoopStats.h"
+
+#include <algorithm>
+#include <bit>
+
+LoopStats& LoopStats::operator+=(const LoopStats& other) {
+    polls += other.polls;
+    activeChannels += other.activeChannels;
+    maxActiveChannels = std::max(maxActiveChannels, other.maxActiveChannels);
+    pollMicros += other.pollMicros;
+    handlerMicros += other.handlerMicros;
+    functorMicros += other.functorMicros;
+    functors += other.functors;
+    functorBatches += other.functorBatches;
+    maxFunctorBatch = std::max(maxFunctorBatch, other.maxFunctorBatch);
+    deferredBatches += other.deferredBatches;
+    timersFired += other.timersFired;
+    maxLagMicros = std::max(maxLagMicros, other.maxLagMicros);
+    for (size_t i = 0; i < kLagBuckets; ++i) {
+        lagHistogram[i] += other.lagHistogram[i];
+    }
+    return *this;
+}
+
+double LoopStats::avgActiveChannels() const {
+    return polls == 0 ? 0.0 : static_cast<double>(activeChannels) / static_cast<double>(polls);
+}
+
+double LoopStats::avgFunctorBatch() const {
+    return functorBatches == 0 ? 0.0 : static_cast<double>(functors) / static_cast<double>(functorBatches);
+}
+
+double LoopStats::busyRatio() const {
+    int64_t busy = handlerMicros + functorMicros;
+    int64_t total = busy + pollMicros;
+    return total <= 0 ? 0.0 : static_cast<double>(busy) / static_cast<double>(total);
+}
+
+int64_t LoopStats::lagPercentile(double p) const {
+    if (timersFired == 0) {
+        return 0;
+    }
+    // 第rank个样本（从1计）所在的桶
+    auto rank = static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(timersFired));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kLagBuckets; ++i) {
+        seen += lagHistogram[i];
+        if (seen >= rank) {
+            return i + 1 == kLagBuckets ? maxLagMicros : lagBucketUpperBound(i);
+        }
+    }
+    return maxLagMicros;
+}
+
+size_t LoopStats::lagBucket(int64_t micros) {
+    if (micros < 2) {
+        return 0;
+    }
+    auto bucket = static_cast<size_t>(std::bit_width(static_cast<uint64_t>(micros))) - 1;  // floor(log2)
+    return std::min(bucket, kLagBuckets - 1);
+}
+
+int64_t LoopStats::lagBucketUpperBound(size_t bucket) {
+    return int64_t{1} << (bucket + 1);
+}
+
+void LoopStatsRecorder::recordPoll(size_t activeChannels, int64_t pollMicros) {
+    add<uint64_t>(polls_, 1);
+    add<uint64_t>(activeChannels_, activeChannels);
+    max<uint64_t>(maxActiveChannels_, activeChannels);
+    add(pollMicros_, pollMicros);
+}
+
+void LoopStatsRecorder::recordFunctors(size_t count, int64_t micros, bool deferred) {
+    if (count == 0) {
+        return;
+    }
+    add<uint64_t>(functors_, count);
+    add<uint64_t>(functorBatches_, 1);
+    max<uint64_t>(maxFunctorBatch_, count);
+    add(functorMicros_, micros);
+    if (deferred) {
+        add<uint64_t>(deferredBatches_, 1);
+    }
+}
+
+void LoopStatsRecorder::recordTimerLag(int64_t micros) {
+    micros = std::max<int64_t>(micros, 0);
+    add<uint64_t>(timersFired_, 1);
+    max(maxLagMicros_, micros);
+    add<uint64_t>(lagHistogram_[LoopStats::lagBucket(micros)], 1);
+}
+
+LoopStats LoopStatsRecorder::snapshot() const {
+    LoopStats stats;
+    stats.polls = polls_.load(std::memory_order_relaxed);
+    stats.activeChannels = activeChannels_.load(std::memory_order_relaxed);
+    stats.maxActiveChannels = maxActiveChannels_.load(std::memory_order_relaxed);
+    stats.pollMicros = pollMicros_.load(std::memory_order_relaxed);
+    stats.handlerMicros = handlerMicros_.load(std::memory_order_relaxed);
+    stats.functorMicros = functorMicros_.load(std::memory_order_relaxed);
+    stats.functors = functors_.load(std::memory_order_relaxed);
+    stats.functorBatches = functorBatches_.load(std::memory_order_relaxed);
+    stats.maxFunctorBatch = maxFunctorBatch_.load(std::memory_order_relaxed);
+    stats.deferredBatches = deferredBatches_.load(std::memory_order_relaxed);
+    stats.timersFired = timersFired_.load(std::memory_order_relaxed);
+    stats.maxLagMicros = maxLagMicros_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LoopStats::kLagBuckets; ++i) {
+        stats.lagHistogram[i] = lagHistogram_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
@@ -0,0 +1,85 @@
+#include "MpscTaskQueue.h"
+
+#include <functional>
+
+namespace {
+uint64_t makeTop(uint64_t oldTop, uint32_t index) {
+    return (((oldTop >> 32) + 1) << 32) | index;  // 每次修改栈顶都推进版本号
+}
+}  // namespace
+
+MpscTaskQueue::MpscTaskQueue() : pool_(new Node[kPoolSize]), freeTop_(1), head_(nullptr), tail_(nullptr), batchEnd_(nullptr) {
+    for (uint32_t i = 0; i + 1 < kPoolSize; ++i) {
+        pool_[i].freeNext.store(i + 2, std::memory_order_relaxed);
+    }
+    Node* stub = allocNode();
+    head_.store(stub, std::memory_order_relaxed);
+    tail_ = stub;
+    batchEnd_ = stub;
+}
+
+MpscTaskQueue::~MpscTaskQueue() {
+    while (tail_ != nullptr) {
+        Node* next = tail_->next.load(std::memory_order_relaxed);
+        if (!fromPool(tail_)) {
+            delete tail_;
+        }
+        tail_ = next;
+    }
+}
+
+bool MpscTaskQueue::fromPool(const Node* node) const {
+    std::less<const Node*> before;
+    return !before(node, pool_.get()) && before(node, pool_.get() + kPoolSize);
+}
+
+MpscTaskQueue::Node* MpscTaskQueue::allocNode() {
+    uint64_t top = freeTop_.load(std::memory_order_acquire);
+    while (true) {
+        const auto index = static_cast<uint32_t>(top);
+        if (index == 0) {
+            return new Node;  // 池已耗尽（积压超过 kPoolSize）
+        }
+        Node* node = &pool_[index - 1];
+        // 读到的后继可能已过时（节点被其他生产者取走又归还），版本号使随后的CAS失败重试
+        const uint32_t next = node->freeNext.load(std::memory_order_relaxed);
+        if (freeTop_.compare_exchange_weak(top, makeTop(top, next), std::memory_order_acquire, std::memory_order_acquire)) {
+            return node;
+        }
+    }
+}
+
+void MpscTaskQueue::freeNode(Node* node) {
+    if (!fromPool(node)) {
+        delete node;
+        return;
+    }
+    node->next.store(nullptr, std::memory_order_relaxed);
+    const auto index = static_cast<uint32_t>(node - pool_.get()) + 1;
+    uint64_t top = freeTop_.load(std::memory_order_relaxed);
+    do {
+        node->freeNext.store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+    } while (!freeTop_.compare_exchange_weak(top, makeTop(top, index), std::memory_order_release, std::memory_order_relaxed));
+}
+
+void MpscTaskQueue::push(Task&& task) {
+    Node* node = allocNode();
+    node->task = std::move(task);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);  // 串行化所有生产者
+    prev->next.store(node, std::memory_order_release);  // 链接后消费者才可见
+}
+
+bool MpscTaskQueue::pop(Task* task) {
+    if (tail_ == batchEnd_) {
+        return false;
+    }
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+    *task = std::move(next->task);
+    next->task = nullptr;  // next 成为新的哨兵
+    freeNode(tail_);
+    tail_ = next;
+    return true;
+}
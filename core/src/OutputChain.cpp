@@ -0,0 +1,218 @@
+#include "OutputChain.h"
+
+#include <errno.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+
+void OutputChain::append(const void* data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (segments_.empty() || segments_.back().type != kOwned) {
+        segments_.push_back(Segment{.type = kOwned});
+    }
+    Segment& tail = segments_.back();
+    if (tail.pos >= kCompactThreshold) {
+        tail.owned.erase(0, tail.pos);  // 回收已写出的前缀，避免持续追加时无限增长
+        tail.pos = 0;
+    }
+    tail.owned.append(static_cast<const char*>(data), len);
+    tail.len += len;
+    bytes_ += len;
+}
+
+void OutputChain::append(const BufferSlice& slice) {
+    const size_t len = slice.size();
+    if (len == 0) {
+        return;
+    }
+    segments_.push_back(Segment{.type = kShared, .owner = slice.owner(), .data = slice.data(), .len = len});
+    bytes_ += len;
+}
+
+void OutputChain::appendFile(int fd, off_t offset, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    segments_.push_back(Segment{.type = kFile, .fd = fd, .offset = offset, .len = len});
+    bytes_ += len;
+    fileBytes_ += len;
+}
+
+size_t OutputChain::writeTo(int fd, size_t maxBytes, int* saveErrno) {
+    *saveErrno = 0;
+    size_t total = 0;
+    while (!segments_.empty() && total < maxBytes) {
+        size_t want = 0;  // 本次系统调用期望写出的字节数，用于判断短写
+        const Segment& front = segments_.front();
+        size_t n = 0;
+        if (front.type == kFile) {
+            n = writeFile(fd, maxBytes - total, &want, saveErrno);
+        } else if (zeroCopyEligible(front)) {
+            n = writeZeroCopy(fd, maxBytes - total, &want, saveErrno);
+        } else {
+            n = writeMemory(fd, maxBytes - total, &want, saveErrno);
+        }
+        total += n;
+        if (*saveErrno != 0 || n < want) {
+            break;  // 出错或内核缓冲已满
+        }
+    }
+    return total;
+}
+
+size_t OutputChain::writeMemory(int fd, size_t maxBytes, size_t* want, int* saveErrno) {
+    struct iovec vec[kMaxIov];
+    size_t iovcnt = 0;
+    for (auto it = segments_.begin(); it != segments_.end() && it->type != kFile && iovcnt < kMaxIov && *want < maxBytes; ++it) {
+        if (zeroCopyEligible(*it)) {
+            break;  // 大片段留给下一轮单独零拷贝发送
+        }
+        const size_t len = std::min(it->len, maxBytes - *want);
+        vec[iovcnt].iov_base = const_cast<char*>(peek(*it));
+        vec[iovcnt].iov_len = len;
+        ++iovcnt;
+        *want += len;
+    }
+
+    // sendmsg + MSG_NOSIGNAL：对端已关闭时返回 EPIPE 而不是触发 SIGPIPE
+    struct msghdr msg {};
+    msg.msg_iov = vec;
+    msg.msg_iovlen = iovcnt;
+    const ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if (n < 0) {
+        *saveErrno = errno;
+        return 0;
+    }
+    consume(static_cast<size_t>(n));
+    return static_cast<size_t>(n);
+}
+
+size_t OutputChain::writeZeroCopy(int fd, size_t maxBytes, size_t* want, int* saveErrno) {
+    Segment& seg = segments_.front();
+    *want = std::min(seg.len, maxBytes);
+    struct iovec vec;
+    vec.iov_base = const_cast<char*>(seg.data);
+    vec.iov_len = *want;
+    struct msghdr msg {};
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_ZEROCOPY);
+    if (n < 0 && errno == ENOBUFS) {
+        // 锁页额度（optmem）不足：本次退回普通发送
+        ++zeroCopyStats_.fallbacks;
+        n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } else if (n >= 0) {
+        // 页面在内核完成通知前仍被引用，保留 owner 防止数据被释放
+        ++zeroCopyStats_.sends;
+        zeroCopyPending_.push_back(ZeroCopyPending{nextZeroCopyId_++, seg.owner});
+    }
+    if (n < 0) {
+        *saveErrno = errno;
+        return 0;
+    }
+    consume(static_cast<size_t>(n));
+    return static_cast<size_t>(n);
+}
+
+std::vector<std::shared_ptr<const void>> OutputChain::takeZeroCopyOwners() {
+    std::vector<std::shared_ptr<const void>> owners;
+    owners.reserve(zeroCopyPending_.size());
+    for (auto& pending : zeroCopyPending_) {
+        owners.push_back(std::move(pending.owner));
+    }
+    zeroCopyPending_.clear();
+    return owners;
+}
+
+size_t OutputChain::reapZeroCopyCompletions(int fd) {
+    size_t reaped = 0;
+    while (true) {
+        char control[128];
+        struct msghdr msg {};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &msg, MSG_ERRQUEUE) < 0) {
+            break;  // EAGAIN：错误队列已读空
+        }
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+            const bool isRecvErr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!isRecvErr) {
+                continue;
+            }
+            struct sock_extended_err serr;
+            ::memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+            if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            // [ee_info, ee_data] 为已完成的调用序号区间（闭区间，按序递增，可能回绕）
+            const uint32_t lo = serr.ee_info;
+            const uint32_t hi = serr.ee_data;
+            const uint32_t count = hi - lo + 1;
+            zeroCopyStats_.completions += count;
+            if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                zeroCopyStats_.copied += count;
+            }
+            while (!zeroCopyPending_.empty() && static_cast<int32_t>(zeroCopyPending_.front().id - hi) <= 0) {
+                zeroCopyPending_.pop_front();
+            }
+            ++reaped;
+        }
+    }
+    return reaped;
+}
+
+size_t OutputChain::writeFile(int fd, size_t maxBytes, size_t* want, int* saveErrno) {
+    Segment& seg = segments_.front();
+    *want = std::min(seg.len, maxBytes);
+    const ssize_t n = ::sendfile(fd, seg.fd, &seg.offset, *want);
+    if (n < 0) {
+        *saveErrno = errno;
+        return 0;
+    }
+    if (n == 0) {
+        // 文件比登记的区间短（被截断），无法再兑现剩余字节
+        *saveErrno = EIO;
+        bytes_ -= seg.len;
+        fileBytes_ -= seg.len;
+        segments_.pop_front();
+        return 0;
+    }
+    seg.len -= static_cast<size_t>(n);
+    bytes_ -= static_cast<size_t>(n);
+    fileBytes_ -= static_cast<size_t>(n);
+    if (seg.len == 0) {
+        segments_.pop_front();
+    }
+    return static_cast<size_t>(n);
+}
+
+void OutputChain::consume(size_t n) {
+    bytes_ -= n;
+    while (n > 0) {
+        Segment& seg = segments_.front();
+        const size_t used = std::min(seg.len, n);
+        seg.len -= used;
+        n -= used;
+        if (seg.type == kOwned) {
+            seg.pos += used;
+        } else {
+            seg.data += used;
+        }
+        if (seg.len == 0) {
+            segments_.pop_front();  // 共享段在此释放 owner，不再持有数据
+        }
+    }
+}
+
+void OutputChain::clear() {
+    segments_.clear();
+    bytes_ = 0;
+    fileBytes_ = 0;
+}
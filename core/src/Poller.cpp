@@ -1,13 +1,25 @@
 #include "Poller.h"
 
+#include <algorithm>
+
 #include "Channel.h"
 #include "EPollPoller.h"
+#include "IoUringPoller.h"
+#include "LogMacros.h"
 
 Poller::Poller(EventLoop* loop) {}
 
 bool Poller::hasChannel(Channel* channel) const {
-    auto it = channels_.find(channel->getFd());
-    return it != channels_.end() && it->second == channel;
+    size_t fd = static_cast<size_t>(channel->getFd());
+    return fd < channels_.size() && channels_[fd].channel == channel;
+}
+
+Poller::ChannelSlot& Poller::slotOf(int fd) {
+    size_t index = static_cast<size_t>(fd);
+    if (index >= channels_.size()) {
+        channels_.resize(std::max(index + 1, channels_.size() * 2));
+    }
+    return channels_[index];
 }
 
 // 静态方法
@@ -15,7 +27,15 @@ Poller* Poller::newDefaultPoller(EventLoop* loop) {
     // 通过环境变量决定使用 poll 还是 epoll
     if (::getenv("MUDUO_USE_POLL")) {
         return nullptr;  // 此处未实现对于poll接口的支持
-    } else {
-        return new EPollPoller(loop);
     }
+    // MUDUO_USE_IOURING 启用 io_uring 后端，MUDUO_IOURING_SQPOLL 额外启用内核SQ轮询线程
+    if (::getenv("MUDUO_USE_IOURING")) {
+        auto* poller = new IoUringPoller(loop, ::getenv("MUDUO_IOURING_SQPOLL") != nullptr);
+        if (poller->valid()) {
+            return poller;
+        }
+        delete poller;
+        LOG_WARN("io_uring unavailable, fallback to epoll");
+    }
+    return new EPollPoller(loop);
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Socket.h"
 
+#include <errno.h>
+#include <linux/filter.h>
 #include <netinet/tcp.h>
 #include <string.h>
 #include <sys/socket.h>
@@ -8,19 +10,27 @@
 
 #include "InetAddress.h"
 #include "LogMacros.h"
+
+namespace {
+void setIntOption(int sockfd, int level, int name, int value, const char* optName) {
+    if (::setsockopt(sockfd, level, name, &value, sizeof(value)) < 0) {
+        LOG_ERROR("setsockopt {} fd:{} value:{} err:{}", optName, sockfd, value, errno);
+    }
+}
+}  // namespace
 Socket::~Socket() {
     LOG_INFO("Socket::~Socket() closing fd={}", sockfd_);
     ::close(sockfd_);
 }
 
 void Socket::bindAddress(const InetAddress& local_addr) {
-    if (::bind(sockfd_, reinterpret_cast<const sockaddr*>(local_addr.getSockAddr()), sizeof(sockaddr_in)) != 0) {
-        LOG_FATAL("bind socket fd:{} fail", sockfd_);
+    if (::bind(sockfd_, local_addr.getSockAddr(), local_addr.getSockLen()) != 0) {
+        LOG_FATAL("bind socket fd:{} to {} fail, err:{}", sockfd_, local_addr.toIpPort(), errno);
     }
 }
 
-void Socket::listen() {
-    if (::listen(sockfd_, 1024) != 0) {
+void Socket::listen(int backlog) {
+    if (::listen(sockfd_, backlog) != 0) {
         LOG_FATAL("listen socket fd:{} fail", sockfd_);
     }
 }
@@ -28,13 +38,13 @@ void Socket::listen() {
 // muduo原则: one loop per thread
 // Reactor模型:poller + non-blocking IO
 int Socket::accept(InetAddress* peerAddr) {
-    sockaddr_in addr;
+    sockaddr_storage addr;
     socklen_t len = sizeof(addr);
     ::memset(&addr, 0, len);
     // 将返回的连接 fd 设置为非阻塞
     int connfd = ::accept4(sockfd_, reinterpret_cast<sockaddr*>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
     if (connfd >= 0) {
-        peerAddr->setSockAddr(addr);
+        peerAddr->setSockAddr(reinterpret_cast<const sockaddr*>(&addr), len);
     }
     return connfd;
 }
@@ -70,3 +80,168 @@ void Socket::setKeepAlive(bool on) {
     int optval = on ? 1 : 0;
     ::setsockopt(sockfd_, SOL_SOCKET, SO_KEEPALIVE, &optval, sizeof(optval));
 }
+
+// SO_BUSY_POLL 让该套接字上的读操作直接轮询网卡队列，以CPU换取更低的接收延迟
+// 超过 net.core.busy_read 时需要 CAP_NET_ADMIN
+void Socket::setBusyPoll(int micros) {
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL, &micros, sizeof(micros)) < 0) {
+        LOG_ERROR("setsockopt SO_BUSY_POLL fd:{} err:{}", sockfd_, errno);
+    }
+}
+
+bool Socket::setZeroCopy(bool on) {
+    int optval = on ? 1 : 0;
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof(optval)) < 0) {
+        LOG_WARN("setsockopt SO_ZEROCOPY fd:{} err:{}", sockfd_, errno);
+        return false;
+    }
+    return true;
+}
+
+void Socket::setLinger(bool on, int seconds) {
+    linger opt = {on ? 1 : 0, seconds};
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_LINGER, &opt, sizeof(opt)) < 0) {
+        LOG_ERROR("setsockopt SO_LINGER fd:{} err:{}", sockfd_, errno);
+    }
+}
+
+// SO_INCOMING_CPU 用于 reuseport 组内选择监听套接字：优先匹配处理该连接软中断的CPU
+void Socket::setIncomingCpu(int cpu) {
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu)) < 0) {
+        LOG_ERROR("setsockopt SO_INCOMING_CPU fd:{} cpu:{} err:{}", sockfd_, cpu, errno);
+    }
+}
+
+// 为整个 reuseport 组挂载 cBPF 程序：返回值 = 当前CPU % groupSize，即组内第几个监听套接字
+// 组内序号按 listen() 的先后顺序分配
+bool Socket::attachReusePortCpuSteering(unsigned groupSize) {
+    sock_filter code[] = {
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<__u32>(SKF_AD_OFF + SKF_AD_CPU)},  // A = 当前CPU
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, groupSize},  // A = A % groupSize
+        {BPF_RET | BPF_A, 0, 0, 0},  // 返回 A
+    };
+    sock_fprog prog = {static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        LOG_ERROR("setsockopt SO_ATTACH_REUSEPORT_CBPF fd:{} err:{}", sockfd_, errno);
+        return false;
+    }
+    return true;
+}
+
+void Socket::setRecvBuffer(int bytes) {
+    setIntOption(sockfd_, SOL_SOCKET, SO_RCVBUF, bytes, "SO_RCVBUF");
+}
+
+void Socket::setSendBuffer(int bytes) {
+    setIntOption(sockfd_, SOL_SOCKET, SO_SNDBUF, bytes, "SO_SNDBUF");
+}
+
+// TCP_FASTOPEN：允许客户端在SYN中携带数据（凭cookie），服务端握手完成前即可读到请求
+void Socket::setFastOpen(int queueLen) {
+    setIntOption(sockfd_, IPPROTO_TCP, TCP_FASTOPEN, queueLen, "TCP_FASTOPEN");
+}
+
+// TCP_DEFER_ACCEPT：只有收到数据的连接才进入可accept状态，超时后仍按普通连接交付
+void Socket::setDeferAccept(int seconds) {
+    setIntOption(sockfd_, IPPROTO_TCP, TCP_DEFER_ACCEPT, seconds, "TCP_DEFER_ACCEPT");
+}
+
+void Socket::setNotSentLowat(int bytes) {
+    setIntOption(sockfd_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, bytes, "TCP_NOTSENT_LOWAT");
+}
+
+void Socket::setUserTimeout(int millis) {
+    setIntOption(sockfd_, IPPROTO_TCP, TCP_USER_TIMEOUT, millis, "TCP_USER_TIMEOUT");
+}
+
+void Socket::setKeepAliveProbes(int idleSeconds, int intervalSeconds, int count) {
+    if (idleSeconds > 0) {
+        setIntOption(sockfd_, IPPROTO_TCP, TCP_KEEPIDLE, idleSeconds, "TCP_KEEPIDLE");
+    }
+    if (intervalSeconds > 0) {
+        setIntOption(sockfd_, IPPROTO_TCP, TCP_KEEPINTVL, intervalSeconds, "TCP_KEEPINTVL");
+    }
+    if (count > 0) {
+        setIntOption(sockfd_, IPPROTO_TCP, TCP_KEEPCNT, count, "TCP_KEEPCNT");
+    }
+}
+
+void Socket::applyListenOptions(const SocketOptions& opts, bool tcp) {
+    if (opts.recvBufferBytes > 0) {
+        setRecvBuffer(opts.recvBufferBytes);
+    }
+    if (opts.sendBufferBytes > 0) {
+        setSendBuffer(opts.sendBufferBytes);
+    }
+    if (!tcp) {
+        return;
+    }
+    if (opts.fastOpenQueue > 0) {
+        setFastOpen(opts.fastOpenQueue);
+    }
+    if (opts.deferAcceptSeconds > 0) {
+        setDeferAccept(opts.deferAcceptSeconds);
+    }
+}
+
+// 只设置与内核默认不同的选项，每个新连接的系统调用数随启用的选项增加
+void Socket::applyConnectionOptions(const SocketOptions& opts, bool tcp) {
+    if (!tcp) {
+        // Unix 域连接不继承监听套接字的缓冲区大小
+        if (opts.recvBufferBytes > 0) {
+            setRecvBuffer(opts.recvBufferBytes);
+        }
+        if (opts.sendBufferBytes > 0) {
+            setSendBuffer(opts.sendBufferBytes);
+        }
+        return;
+    }
+    if (opts.tcpNoDelay) {
+        setTcpNoDelay(true);
+    }
+    if (opts.notSentLowatBytes > 0) {
+        setNotSentLowat(opts.notSentLowatBytes);
+    }
+    if (opts.userTimeoutMillis > 0) {
+        setUserTimeout(opts.userTimeoutMillis);
+    }
+    if (opts.keepAlive) {
+        setKeepAlive(true);
+        setKeepAliveProbes(opts.keepIdleSeconds, opts.keepIntervalSeconds, opts.keepCount);
+    }
+}
+
+InetAddress Socket::getLocalAddr(int sockfd) {
+    sockaddr_storage local;
+    socklen_t addrLen = sizeof(local);
+    ::memset(&local, 0, addrLen);
+    if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&local), &addrLen) < 0) {
+        LOG_ERROR("getsockname fd:{} err:{}", sockfd, errno);
+    }
+    return InetAddress(reinterpret_cast<const sockaddr*>(&local), addrLen);
+}
+
+InetAddress Socket::getPeerAddr(int sockfd) {
+    sockaddr_storage peer;
+    socklen_t addrLen = sizeof(peer);
+    ::memset(&peer, 0, addrLen);
+    if (::getpeername(sockfd, reinterpret_cast<sockaddr*>(&peer), &addrLen) < 0) {
+        LOG_ERROR("getpeername fd:{} err:{}", sockfd, errno);
+    }
+    return InetAddress(reinterpret_cast<const sockaddr*>(&peer), addrLen);
+}
+
+int Socket::getSocketError(int sockfd) {
+    int optval = 0;
+    socklen_t optlen = sizeof(optval);
+    if (::getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0) {
+        return errno;
+    }
+    return optval;
+}
+
+bool Socket::isSelfConnect(int sockfd) {
+    const InetAddress local = getLocalAddr(sockfd);
+    const InetAddress peer = getPeerAddr(sockfd);
+    return !local.isUnix() && local == peer;
+}
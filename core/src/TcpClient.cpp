@@ -0,0 +1,102 @@
+#include "TcpClient.h"
+
+#include "Connector.h"
+#include "EventLoop.h"
+#include "LogMacros.h"
+#include "Socket.h"
+
+TcpClient::TcpClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& nameArg) :
+    loop_(loop),
+    connector_(std::make_shared<Connector>(loop, serverAddr)),
+    name_(nameArg),
+    connNamePrefix_(std::make_shared<const std::string>(nameArg)),
+    connectionCallback_([](const TcpConnectionPtr&) {}),
+    messageCallback_([](const TcpConnectionPtr&, Buffer* buf, Timestamp) { buf->retrieveAll(); }),
+    retry_(false),
+    connect_(false),
+    nextConnId_(1)
+{
+    connector_->setNewConnectionCallback([this](int sockfd) { newConnection(sockfd); });
+    LOG_INFO("TcpClient::TcpClient [{}] connector {}", name_, serverAddr.toIpPort());
+}
+
+TcpClient::~TcpClient() {
+    LOG_INFO("TcpClient::~TcpClient [{}]", name_);
+    TcpConnectionPtr conn;
+    bool unique = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unique = connection_.use_count() == 1;
+        conn = connection_;
+    }
+    if (conn) {
+        // 客户端先于连接销毁：关闭回调不能再引用 this，改为直接销毁连接
+        EventLoop* loop = loop_;
+        conn->setCloseCallback([loop](const TcpConnectionPtr& c) { loop->queueInLoop([c] { c->connectDestroyed(); }); });
+        if (unique) {
+            conn->forceClose();
+        }
+    }
+    connector_->stop();
+}
+
+void TcpClient::connect() {
+    LOG_INFO("TcpClient::connect [{}] connecting to {}", name_, connector_->serverAddress().toIpPort());
+    connect_ = true;
+    connector_->start();
+}
+
+void TcpClient::disconnect() {
+    connect_ = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connection_) {
+        connection_->shutdown();
+    }
+}
+
+void TcpClient::stop() {
+    connect_ = false;
+    connector_->stop();
+}
+
+void TcpClient::setConnectTimeout(double seconds) {
+    connector_->setConnectTimeout(seconds);
+}
+
+void TcpClient::setRetryDelay(double initialSeconds, double maxSeconds) {
+    connector_->setRetryDelay(initialSeconds, maxSeconds);
+}
+
+void TcpClient::setMaxAttempts(int n) {
+    connector_->setMaxAttempts(n);
+}
+
+void TcpClient::setConnectFailedCallback(std::function<void()> cb) {
+    connector_->setConnectFailedCallback(std::move(cb));
+}
+
+void TcpClient::newConnection(int sockfd) {
+    auto conn = std::allocate_shared<TcpConnection>(SlabAllocator<TcpConnection>(loop_->connectionSlab()), loop_, nextConnId_++, connNamePrefix_, sockfd, Socket::getLocalAddr(sockfd), Socket::getPeerAddr(sockfd));
+    conn->applySocketOptions(SocketOptions());  // 默认开启 NODELAY 与 keepalive
+    conn->setConnectionCallback(connectionCallback_);
+    conn->setMessageCallback(messageCallback_);
+    conn->setWriteCompleteCallback(writeCompleteCallback_);
+    conn->setCloseCallback([this](const TcpConnectionPtr& c) { removeConnection(c); });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_ = conn;
+    }
+    conn->connectEstablished();
+}
+
+void TcpClient::removeConnection(const TcpConnectionPtr& conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_.reset();
+    }
+    loop_->queueInLoop([conn] { conn->connectDestroyed(); });
+    if (retry_ && connect_) {
+        LOG_INFO("TcpClient::removeConnection [{}] reconnecting to {}", name_, connector_->serverAddress().toIpPort());
+        connector_->restart();
+    }
+}
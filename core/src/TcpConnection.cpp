@@ -2,19 +2,18 @@
 
 #include <errno.h>
 #include <sys/sendfile.h>  // for sendfile
+#include <sys/uio.h>  // for iovec
+
+#include <algorithm>
+#include <limits>
 
-#include "Channel.h"
 #include "EventLoop.h"
 #include "LogMacros.h"
-#include "Socket.h"
-
-struct PendingFile {
-    int    fd = -1;
-    off_t  offset = 0;
-    size_t remaining = 0;
-    bool   active = false;
-};
-PendingFile pendingFile_;
+
+namespace {
+constexpr size_t kMaxSendIov = 64;  // sendSlicesInLoop 单次 writev 的最大片段数
+}  // namespace
+
 static EventLoop* CheckLoopNotNull(EventLoop* loop) {
     if (loop == nullptr) {
         LOG_FATAL("mainLoop is null!");
@@ -22,28 +21,56 @@ static EventLoop* CheckLoopNotNull(EventLoop* loop) {
     return loop;
 }
 
-TcpConnection::TcpConnection(EventLoop* loop, const std::string& nameArg, int sockfd, const InetAddress& localAddr, const InetAddress& peerAddr) :
+TcpConnection::TcpConnection(EventLoop* loop, uint64_t id, std::shared_ptr<const std::string> namePrefix, int sockfd, const InetAddress& localAddr, const InetAddress& peerAddr) :
     loop_(CheckLoopNotNull(loop)),
     state_(kConnecting),
     reading_(true),
-    socket_(std::make_unique<Socket>(sockfd)),
-    channel_(std::make_unique<Channel>(loop, sockfd)),
-    name_(nameArg),
+    edgeTriggered_(false),
+    writing_(false),
+    ioBudget_(0),
+    socket_(sockfd),
+    channel_(loop, sockfd),
+    id_(id),
+    namePrefix_(std::move(namePrefix)),
     localAddr_(localAddr),
     peerAddr_(peerAddr),
-    highWaterMark_(64 * 1024 * 1024)  // 64MB
+    highWaterMark_(64 * 1024 * 1024),  // 64MB
+    backpressured_(false),
+    backpressureHigh_(0),
+    backpressureLow_(0),
+    accountedBytes_(0),
+    idleTimeout_(0.0),
+    readTimeout_(0.0),
+    writeStallTimeout_(0.0),
+    idleEntry_([this] { handleTimeout("idle"); }),
+    readEntry_([this] { handleTimeout("read"); }),
+    writeStallEntry_([this] { handleTimeout("write stall"); })
 {
-    channel_->setReadCallback([this](Timestamp t) { handleRead(t); });
-    channel_->setWriteCallback([this]() { handleWrite(); });
-    channel_->setCloseCallback([this]() { handleClose(); });
-    channel_->setErrorCallback([this]() { handleError(); });
+    channel_.setReadCallback([this](Timestamp t) { handleRead(t); });
+    channel_.setWriteCallback([this]() { handleWrite(); });
+    channel_.setCloseCallback([this]() { handleClose(); });
+    channel_.setErrorCallback([this]() { handleError(); });
 
-    socket_->setKeepAlive(true);
-    LOG_TRACE("TcpConnection::ctor [{}] fd = {}", name_, sockfd);
+    loop_->connectionAdded();  // 创建即计入，分配策略在连接建立前就能看到
+    LOG_TRACE("TcpConnection::ctor [{}#{}] fd = {}", *namePrefix_, id_, sockfd);
 }
 
 TcpConnection::~TcpConnection() {
-    LOG_INFO("TcpConnection::dtor [{}] fd = {} state = {}", name_, channel_->getFd(), state_.load());
+    if (outputChain_.hasZeroCopyPending()) {
+        outputChain_.reapZeroCopyCompletions(channel_.getFd());
+    }
+    if (outputChain_.hasZeroCopyPending()) {
+        // 内核仍引用零拷贝页（强制关闭、超时等路径）：中止连接使 close 丢弃发送/重传队列，
+        // 数据持有者交给loop延后释放，保证在 socket_ 关闭fd之后才归还内存
+        LOG_WARN("TcpConnection [{}#{}] closed with pending zerocopy sends, abort", *namePrefix_, id_);
+        socket_.setLinger(true, 0);
+        loop_->queueInLoop([owners = outputChain_.takeZeroCopyOwners()] {});
+    }
+    if (outputBudget_) {
+        outputBudget_->sub(accountedBytes_);  // 输出链内存随连接释放
+    }
+    loop_->connectionRemoved();
+    LOG_INFO("TcpConnection::dtor [{}#{}] fd = {} state = {}", *namePrefix_, id_, channel_.getFd(), state_.load());
 }
 
 // ===================== send 系列 =====================
@@ -52,6 +79,10 @@ void TcpConnection::send(const std::string& buf) {
     send(buf.data(), buf.size());
 }
 
+void TcpConnection::send(std::string&& buf) {
+    send(BufferSlice(std::move(buf)));
+}
+
 void TcpConnection::send(const void* data, size_t len) {
     if (state_ != kConnected)
         return;
@@ -59,11 +90,10 @@ void TcpConnection::send(const void* data, size_t len) {
     if (loop_->isInLoopThread()) {
         sendInLoop(data, len);
     } else {
-        // 拷贝数据，防止原缓冲释放
-        std::string copy(static_cast<const char*>(data), len);
-        loop_->runInLoop([self = shared_from_this(), copy]() {
+        // 拷贝一次数据，防止原缓冲释放；未发完时该片段直接入链，不再二次拷贝
+        loop_->runInLoop([self = shared_from_this(), slice = BufferSlice::copyOf(data, len)]() {
             if (self->state_ == kConnected) {
-                self->sendInLoop(copy.data(), copy.size());
+                self->sendSlicesInLoop(&slice, 1);
             }
         });
     }
@@ -80,12 +110,38 @@ void TcpConnection::send(Buffer* buf) {
         sendInLoop(buf->peek(), buf->readableBytes());
         buf->retrieveAll();
     } else {
-        std::string copy(buf->peek(), buf->readableBytes());
-        buf->retrieveAll();
-        auto self = shared_from_this();
-        loop_->runInLoop([self, copy = std::move(copy)]() {
+        BufferSlice slice(buf->retrieveAllAsString());
+        loop_->runInLoop([self = shared_from_this(), slice = std::move(slice)]() {
+            if (self->state_ == kConnected)
+                self->sendSlicesInLoop(&slice, 1);
+        });
+    }
+}
+
+void TcpConnection::send(const BufferSlice& slice) {
+    if (state_ != kConnected || slice.empty())
+        return;
+
+    if (loop_->isInLoopThread()) {
+        sendSlicesInLoop(&slice, 1);
+    } else {
+        loop_->runInLoop([self = shared_from_this(), slice]() {
+            if (self->state_ == kConnected)
+                self->sendSlicesInLoop(&slice, 1);
+        });
+    }
+}
+
+void TcpConnection::send(std::vector<BufferSlice> slices) {
+    if (state_ != kConnected || slices.empty())
+        return;
+
+    if (loop_->isInLoopThread()) {
+        sendSlicesInLoop(slices.data(), slices.size());
+    } else {
+        loop_->runInLoop([self = shared_from_this(), slices = std::move(slices)]() {
             if (self->state_ == kConnected)
-                self->sendInLoop(copy.data(), copy.size());
+                self->sendSlicesInLoop(slices.data(), slices.size());
         });
     }
 }
@@ -111,30 +167,66 @@ void TcpConnection::shutdown() {
     }
 }
 
+void TcpConnection::forceClose() {
+    if (state_ == kConnected || state_ == kDisconnecting) {
+        setState(kDisconnecting);
+        loop_->queueInLoop([self = shared_from_this()] { self->forceCloseInLoop(); });
+    }
+}
+
+void TcpConnection::startRead() {
+    loop_->runInLoop([self = shared_from_this()] { self->startReadInLoop(); });
+}
+
+void TcpConnection::stopRead() {
+    loop_->runInLoop([self = shared_from_this()] { self->stopReadInLoop(); });
+}
+
 // ===================== 生命周期管理 =====================
 
 void TcpConnection::connectEstablished() {
     setState(kConnected);
-    channel_->tie(shared_from_this());
-    channel_->enableReading();  // 注册EPOLLIN事件
+    channel_.tie(shared_from_this());
+    if (edgeTriggered_ && !loop_->supportsEdgeTriggered()) {
+        edgeTriggered_ = false;  // 后端不支持ET（如io_uring），回退为水平触发
+    }
+    if (edgeTriggered_) {
+        channel_.setEdgeTriggered(true);
+        channel_.enableAll();  // 一次性注册 EPOLLIN|EPOLLOUT|EPOLLET
+        updateReadInterest();  // 建立前已 stopRead 时撤掉EPOLLIN
+    } else {
+        updateReadInterest();  // 注册EPOLLIN事件
+    }
+    if (idleTimeout_ > 0.0) {
+        loop_->timingWheel()->schedule(&idleEntry_, idleTimeout_);
+    }
+    startReadTimeout();
     connectionCallback_(shared_from_this());
 }
 
 void TcpConnection::connectDestroyed() {
-    LOG_INFO("connectDestroyed() fd={} state={}", channel_->getFd(), state_.load());
+    LOG_INFO("connectDestroyed() fd={} state={}", channel_.getFd(), state_.load());
+    cancelTimeouts();
     if (state_ == kConnected) {
         setState(kDisconnected);
-        channel_->disableAll();
+        channel_.disableAll();
     }
-    channel_->remove();
+    channel_.remove();
 }
 
 // ===================== 事件回调 =====================
 
 void TcpConnection::handleRead(Timestamp receiveTime) {
+    if (edgeTriggered_) {
+        handleReadEdgeTriggered(receiveTime);
+        return;
+    }
     int saveErrno = 0;
-    ssize_t n = inputBuffer_.readFd(channel_->getFd(), &saveErrno);
+    ssize_t n = inputBuffer_.readFd(channel_.getFd(), &saveErrno);
     if (n > 0) {
+        if (idleTimeout_ > 0.0) {
+            loop_->timingWheel()->touch(&idleEntry_, idleTimeout_);  // O(1)：只推迟截止时间
+        }
         messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
     } else if (n == 0) {
         handleClose();
@@ -144,72 +236,99 @@ void TcpConnection::handleRead(Timestamp receiveTime) {
         handleError();
     }
 }
-void TcpConnection::handleWrite() {
-    // 先处理待续传文件
-    if (pendingFile_.active) {
-        ssize_t n = ::sendfile(socket_->getSocketFd(), pendingFile_.fd, &pendingFile_.offset, pendingFile_.remaining);
-        if (n >= 0) {
-            pendingFile_.remaining -= static_cast<size_t>(n);
-            if (pendingFile_.remaining == 0) {
-                pendingFile_.active = false;
-                // 文件发完后，继续走缓冲区逻辑
-                if (writeCompleteCallback_ && outputBuffer_.readableBytes() == 0) {
-                    auto self = shared_from_this();
-                    loop_->queueInLoop([self] {
-                        if (self->writeCompleteCallback_)
-                            self->writeCompleteCallback_(self);
-                    });
-                }
-            } else {
-                channel_->enableWriting();  // 继续等待下一次可写
-                return;
+// ET模式：循环读到EAGAIN再统一上报，超过预算则让出，在本轮pendingFunctors中继续读
+void TcpConnection::handleReadEdgeTriggered(Timestamp receiveTime) {
+    size_t total = 0;
+    bool peerClosed = false;
+    bool budgetExhausted = false;
+    int saveErrno = 0;
+    while (true) {
+        ssize_t n = inputBuffer_.readFd(channel_.getFd(), &saveErrno);
+        if (n > 0) {
+            total += static_cast<size_t>(n);
+            if (total >= ioBudget_) {
+                budgetExhausted = true;
+                break;
             }
+        } else if (n == 0) {
+            peerClosed = true;
+            break;
         } else {
-            if (errno == EWOULDBLOCK) {
-                channel_->enableWriting();
-                return;
+            if (saveErrno == EAGAIN || saveErrno == EWOULDBLOCK) {
+                saveErrno = 0;
             }
-            if (errno == EPIPE || errno == ECONNRESET) {
-                handleClose();
-                return;
-            }
-            LOG_ERROR("TcpConnection::handleWrite sendfile errno = {}", errno);
-            pendingFile_.active = false;  // 降级：停止续传
+            break;
         }
     }
 
-    // 再处理内存缓冲
-    if (!channel_->isWriting()) {
-        LOG_WARN("handleWrite called but not writing fd = {}", channel_->getFd());
+    if (total > 0) {
+        if (idleTimeout_ > 0.0) {
+            loop_->timingWheel()->touch(&idleEntry_, idleTimeout_);
+        }
+        messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+    }
+    if (peerClosed) {
+        handleClose();
+    } else if (saveErrno != 0) {
+        errno = saveErrno;
+        LOG_ERROR("TcpConnection::handleRead() errno = {}", errno);
+        handleError();
+    } else if (budgetExhausted && state_ == kConnected) {
+        // 边缘触发不会再次通知，自行续读
+        loop_->queueInLoop([self = shared_from_this(), receiveTime] {
+            if (self->state_ == kConnected && self->channel_.isReading()) {  // 期间可能已暂停读取
+                self->handleReadEdgeTriggered(receiveTime);
+            }
+        });
+    }
+}
+
+void TcpConnection::handleWrite() {
+    if (!isWriting()) {
+        if (!edgeTriggered_) {  // ET模式下EPOLLOUT常驻，随读事件一起上报属正常情况
+            LOG_WARN("handleWrite called but not writing fd = {}", channel_.getFd());
+        }
         return;
     }
+    // 按入队顺序写出内存段与文件段：LT模式写到内核缓冲满为止；ET模式另受预算限制
     int saveErrno = 0;
-    ssize_t n = outputBuffer_.writeFd(channel_->getFd(), &saveErrno);
+    const size_t budget = edgeTriggered_ ? ioBudget_ : std::numeric_limits<size_t>::max();
+    const size_t n = outputChain_.writeTo(channel_.getFd(), budget, &saveErrno);
     if (n > 0) {
-        outputBuffer_.retrieve(n);
-        if (outputBuffer_.readableBytes() == 0) {
-            channel_->disableWriting();
-            if (writeCompleteCallback_) {
-                auto self = shared_from_this();
-                loop_->queueInLoop([self] {
-                    if (self->writeCompleteCallback_)
-                        self->writeCompleteCallback_(self);
-                });
-            }
-            if (state_ == kDisconnecting) {
-                shutdownInLoop();
-            }
-        }
-    } else {
+        onWriteProgress();
+    }
+    if (saveErrno != 0 && saveErrno != EAGAIN && saveErrno != EWOULDBLOCK) {
         errno = saveErrno;
         LOG_ERROR("TcpConnection::handleWrite() errno = {}", errno);
+        outputChain_.clear();  // 输出流已无法完整送达（对端断开或文件被截断）
+        updateOutputBackpressure();
+        handleClose();
+        return;
+    }
+    updateOutputBackpressure();
+
+    if (outputChain_.empty()) {
+        disableWriting();
+        loop_->timingWheel()->cancel(&writeStallEntry_);
+        queueWriteComplete();  // 整条输出链发完只通知一次
+        if (state_ == kDisconnecting) {
+            shutdownInLoop();
+        }
+    } else if (edgeTriggered_ && n >= budget) {
+        // 预算耗尽但仍可写：让出给其他连接，在本轮pendingFunctors中继续写
+        loop_->queueInLoop([self = shared_from_this()] {
+            if (self->state_ != kDisconnected) {
+                self->handleWrite();
+            }
+        });
     }
 }
 
 void TcpConnection::handleClose() {
-    LOG_INFO("TcpConnection::handleClose fd = {} state = {}", channel_->getFd(), state_.load());
+    LOG_INFO("TcpConnection::handleClose fd = {} state = {}", channel_.getFd(), state_.load());
     setState(kDisconnected);
-    channel_->disableAll();
+    channel_.disableAll();
+    cancelTimeouts();
 
     auto self = shared_from_this();
     // 不要再次调用 connectionCallback_，防止上层重复处理
@@ -218,22 +337,27 @@ void TcpConnection::handleClose() {
 }
 
 void TcpConnection::handleError() {
+    // 开启零拷贝后，完成通知经错误队列以 EPOLLERR 上报，并非真正的错误；但同一事件可能还带有真正的 SO_ERROR
+    const bool reaped = outputChain_.zeroCopyThreshold() > 0 && outputChain_.reapZeroCopyCompletions(channel_.getFd()) > 0;
     int optval = 0;
     socklen_t optlen = sizeof optval;
     int err = 0;
-    if (::getsockopt(channel_->getFd(), SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0)
+    if (::getsockopt(channel_.getFd(), SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0)
         err = errno;
     else
         err = optval;
+    if (reaped && err == 0) {
+        return;
+    }
 
-    LOG_ERROR("TcpConnection::handleError name = {} SO_ERROR = {}", name_, err);
+    LOG_ERROR("TcpConnection::handleError name = {}#{} SO_ERROR = {}", *namePrefix_, id_, err);
 }
 
 // ===================== 内部逻辑 =====================
 
 void TcpConnection::sendInLoop(const void* data, size_t len) {
     if (state_ == kDisconnected) {
-        LOG_WARN("sendInLoop on disconnected connection [{}]", name_);
+        LOG_WARN("sendInLoop on disconnected connection [{}#{}]", *namePrefix_, id_);
         return;
     }
 
@@ -242,16 +366,13 @@ void TcpConnection::sendInLoop(const void* data, size_t len) {
     bool faultError = false;
 
     // 尝试直接发送
-    if (!channel_->isWriting() && outputBuffer_.readableBytes() == 0) {
-        nwrote = ::send(channel_->getFd(), data, len, MSG_NOSIGNAL);
+    if (!isWriting() && outputChain_.empty()) {
+        nwrote = ::send(channel_.getFd(), data, len, MSG_NOSIGNAL);
         if (nwrote >= 0) {
+            onWriteProgress();
             remaining = len - nwrote;
-            if (remaining == 0 && writeCompleteCallback_) {
-                auto self = shared_from_this();
-                loop_->queueInLoop([self]() {
-                    if (self->writeCompleteCallback_)
-                        self->writeCompleteCallback_(self);
-                });
+            if (remaining == 0) {
+                queueWriteComplete();
             }
         } else {
             nwrote = 0;
@@ -263,17 +384,82 @@ void TcpConnection::sendInLoop(const void* data, size_t len) {
         }
     }
 
-    // 若未发完，存入缓冲区等待EPOLLOUT
+    // 若未发完，追加到输出链等待EPOLLOUT
     if (!faultError && remaining > 0) {
-        size_t oldLen = outputBuffer_.readableBytes();
-        if (oldLen + remaining >= highWaterMark_ && oldLen < highWaterMark_ && highWaterMarkCallback_) {
-            auto self = shared_from_this();
-            loop_->queueInLoop([self, total = oldLen + remaining]() { self->highWaterMarkCallback_(self, total); });
+        const size_t oldLen = outputChain_.readableBytes();
+        outputChain_.append(static_cast<const char*>(data) + nwrote, remaining);
+        onOutputQueued(oldLen);
+    }
+
+    if (faultError)
+        handleClose();
+}
+
+void TcpConnection::sendSlicesInLoop(const BufferSlice* slices, size_t count) {
+    if (state_ == kDisconnected) {
+        LOG_WARN("sendSlicesInLoop on disconnected connection [{}#{}]", *namePrefix_, id_);
+        return;
+    }
+
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i) {
+        len += slices[i].size();
+    }
+    if (len == 0) {
+        return;
+    }
+
+    size_t nwrote = 0;
+    bool faultError = false;
+
+    // 含达到零拷贝阈值的片段时整体入链，由输出链按 MSG_ZEROCOPY 发送
+    const size_t zcThreshold = outputChain_.zeroCopyThreshold();
+    const bool zeroCopy = zcThreshold > 0 && std::any_of(slices, slices + count, [zcThreshold](const BufferSlice& slice) { return slice.size() >= zcThreshold; });
+
+    // 尝试直接 writev，片段数超过 kMaxSendIov 时余下部分入链
+    if (!zeroCopy && !isWriting() && outputChain_.empty()) {
+        struct iovec vec[kMaxSendIov];
+        size_t iovcnt = 0;
+        for (size_t i = 0; i < count && iovcnt < kMaxSendIov; ++i) {
+            if (!slices[i].empty()) {
+                vec[iovcnt].iov_base = const_cast<char*>(slices[i].data());
+                vec[iovcnt].iov_len = slices[i].size();
+                ++iovcnt;
+            }
         }
+        struct msghdr msg {};
+        msg.msg_iov = vec;
+        msg.msg_iovlen = iovcnt;
+        const ssize_t n = ::sendmsg(channel_.getFd(), &msg, MSG_NOSIGNAL);
+        if (n >= 0) {
+            onWriteProgress();
+            nwrote = static_cast<size_t>(n);
+            if (nwrote == len) {
+                queueWriteComplete();
+            }
+        } else if (errno != EWOULDBLOCK) {
+            if (errno == EPIPE || errno == ECONNRESET)
+                faultError = true;
+            LOG_ERROR("TcpConnection::sendSlicesInLoop write error: {}", errno);
+        }
+    }
 
-        outputBuffer_.append(static_cast<const char*>(data) + nwrote, remaining);
-        if (!channel_->isWriting()) {
-            channel_->enableWriting();
+    // 未写出的部分以引用方式入链，不拷贝数据
+    if (!faultError && nwrote < len) {
+        const size_t oldLen = outputChain_.readableBytes();
+        size_t skip = nwrote;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t size = slices[i].size();
+            if (skip >= size) {
+                skip -= size;
+                continue;
+            }
+            outputChain_.append(skip > 0 ? slices[i].slice(skip, size - skip) : slices[i]);
+            skip = 0;
+        }
+        onOutputQueued(oldLen);
+        if (zeroCopy && oldLen == 0) {
+            handleWrite();  // 输出链原本为空：立即尝试发送
         }
     }
 
@@ -281,9 +467,29 @@ void TcpConnection::sendInLoop(const void* data, size_t len) {
         handleClose();
 }
 
+void TcpConnection::onOutputQueued(size_t oldLen) {
+    const size_t total = outputChain_.readableBytes();
+    if (total >= highWaterMark_ && oldLen < highWaterMark_ && highWaterMarkCallback_) {
+        loop_->queueInLoop([self = shared_from_this(), total]() { self->highWaterMarkCallback_(self, total); });
+    }
+    if (!isWriting()) {
+        enableWriting();
+    }
+    armWriteStallTimeout();
+    updateOutputBackpressure();
+}
+
 void TcpConnection::shutdownInLoop() {
-    if (!channel_->isWriting()) {
-        socket_->shutdownWrite();
+    if (!isWriting()) {
+        socket_.shutdownWrite();
+    }
+}
+
+void TcpConnection::forceCloseInLoop() {
+    if (state_ == kConnected || state_ == kDisconnecting) {
+        outputChain_.clear();
+        updateOutputBackpressure();
+        handleClose();
     }
 }
 
@@ -291,35 +497,33 @@ void TcpConnection::sendFileInLoop(int fileDescriptor, off_t offset, size_t coun
     if (state_ != kConnected)
         return;
 
-    // 若缓冲里还有待发数据，优先让缓冲走完，再发文件
-    if (outputBuffer_.readableBytes() > 0 || channel_->isWriting()) {
-        pendingFile_ = {fileDescriptor, offset, count, true};
-        channel_->enableWriting();
+    // 输出链中已有待发数据：文件区间排在其后，保证先后顺序
+    if (!outputChain_.empty() || isWriting()) {
+        outputChain_.appendFile(fileDescriptor, offset, count);
+        enableWriting();
+        armWriteStallTimeout();
         return;
     }
 
-    ssize_t n = ::sendfile(socket_->getSocketFd(), fileDescriptor, &offset, count);
+    ssize_t n = ::sendfile(socket_.getSocketFd(), fileDescriptor, &offset, count);
     if (n >= 0) {
+        onWriteProgress();
         size_t remaining = count - static_cast<size_t>(n);
         if (remaining == 0) {
-            if (writeCompleteCallback_) {
-                auto self = shared_from_this();
-                loop_->queueInLoop([self] {
-                    if (self->writeCompleteCallback_)
-                        self->writeCompleteCallback_(self);
-                });
-            }
+            queueWriteComplete();
             return;
         }
-        // 未发完：注册写事件，后续在 handleWrite() 继续
-        pendingFile_ = {fileDescriptor, offset, remaining, true};
-        channel_->enableWriting();
+        // 未发完：剩余区间入链，后续在 handleWrite() 继续
+        outputChain_.appendFile(fileDescriptor, offset, remaining);
+        enableWriting();
+        armWriteStallTimeout();
         return;
     }
 
     if (errno == EWOULDBLOCK) {
-        pendingFile_ = {fileDescriptor, offset, count, true};
-        channel_->enableWriting();
+        outputChain_.appendFile(fileDescriptor, offset, count);
+        enableWriting();
+        armWriteStallTimeout();
         return;
     }
 
@@ -329,3 +533,148 @@ void TcpConnection::sendFileInLoop(int fileDescriptor, off_t offset, size_t coun
         LOG_ERROR("TcpConnection::sendFileInLoop errno = {}", errno);
     }
 }
+
+void TcpConnection::queueWriteComplete() {
+    if (writeCompleteCallback_) {
+        loop_->queueInLoop([self = shared_from_this()] {
+            if (self->writeCompleteCallback_)
+                self->writeCompleteCallback_(self);
+        });
+    }
+}
+
+// ===================== 超时控制 =====================
+
+void TcpConnection::startReadTimeout() {
+    if (readTimeout_ > 0.0 && !readEntry_.linked()) {
+        loop_->timingWheel()->schedule(&readEntry_, readTimeout_);
+    }
+}
+
+void TcpConnection::cancelReadTimeout() {
+    loop_->timingWheel()->cancel(&readEntry_);
+}
+
+void TcpConnection::armWriteStallTimeout() {
+    if (writeStallTimeout_ > 0.0 && !writeStallEntry_.linked()) {
+        loop_->timingWheel()->schedule(&writeStallEntry_, writeStallTimeout_);
+    }
+}
+
+void TcpConnection::onWriteProgress() {
+    TimingWheel* wheel = loop_->timingWheel();
+    if (idleTimeout_ > 0.0) {
+        wheel->touch(&idleEntry_, idleTimeout_);
+    }
+    if (writeStallEntry_.linked()) {
+        wheel->touch(&writeStallEntry_, writeStallTimeout_);
+    }
+}
+
+void TcpConnection::cancelTimeouts() {
+    TimingWheel* wheel = loop_->timingWheel();
+    wheel->cancel(&idleEntry_);
+    wheel->cancel(&readEntry_);
+    wheel->cancel(&writeStallEntry_);
+}
+
+void TcpConnection::handleTimeout(const char* reason) {
+    if (state_ == kDisconnected) {
+        return;
+    }
+    LOG_WARN("TcpConnection::handleTimeout [{}#{}] fd = {} {} timeout, force close", *namePrefix_, id_, channel_.getFd(), reason);
+    handleClose();
+}
+
+void TcpConnection::setBusyPoll(int micros) {
+    socket_.setBusyPoll(micros);
+}
+
+void TcpConnection::setZeroCopy(size_t threshold) {
+    if (threshold > 0 && !socket_.setZeroCopy(true)) {
+        threshold = 0;  // 内核不支持 SO_ZEROCOPY：保持普通发送
+    }
+    outputChain_.setZeroCopyThreshold(threshold);
+}
+
+// ===================== 读流控 =====================
+
+void TcpConnection::setOutputBackpressure(size_t highMark, size_t lowMark, std::shared_ptr<OutputBudget> budget) {
+    backpressureHigh_ = highMark;
+    backpressureLow_ = lowMark < highMark ? lowMark : highMark / 2;
+    outputBudget_ = std::move(budget);
+}
+
+void TcpConnection::startReadInLoop() {
+    reading_ = true;
+    updateReadInterest();
+}
+
+void TcpConnection::stopReadInLoop() {
+    reading_ = false;
+    updateReadInterest();
+}
+
+void TcpConnection::updateReadInterest() {
+    if (state_ == kDisconnected) {
+        return;
+    }
+    const bool want = reading_ && !backpressured_;
+    if (want && !channel_.isReading()) {
+        channel_.enableReading();  // ET下重新MOD会立即报告内核缓冲中已有的数据
+    } else if (!want && channel_.isReading()) {
+        channel_.disableReading();
+    }
+}
+
+void TcpConnection::updateOutputBackpressure() {
+    const size_t bytes = outputChain_.memoryBytes();  // 文件段不占内存，不计入
+    if (outputBudget_ && bytes != accountedBytes_) {
+        if (bytes > accountedBytes_) {
+            outputBudget_->add(bytes - accountedBytes_);
+        } else {
+            outputBudget_->sub(accountedBytes_ - bytes);
+        }
+        accountedBytes_ = bytes;
+    }
+    if (backpressureHigh_ == 0 && !outputBudget_) {
+        return;
+    }
+
+    if (!backpressured_) {
+        const bool overHigh = backpressureHigh_ > 0 && bytes >= backpressureHigh_;
+        // 预算超限时只暂停积压较多的连接，输出很少的连接照常读取
+        const bool overBudget = outputBudget_ && outputBudget_->exceeded() && bytes > backpressureLow_;
+        if (overHigh || overBudget) {
+            backpressured_ = true;
+            LOG_DEBUG("TcpConnection::updateOutputBackpressure [{}#{}] pause reading, output {} bytes", *namePrefix_, id_, bytes);
+            updateReadInterest();
+        }
+    } else if (bytes <= backpressureLow_) {
+        backpressured_ = false;
+        LOG_DEBUG("TcpConnection::updateOutputBackpressure [{}#{}] resume reading, output {} bytes", *namePrefix_, id_, bytes);
+        updateReadInterest();
+    }
+}
+
+// ===================== 写事件关注 =====================
+
+bool TcpConnection::isWriting() const {
+    return edgeTriggered_ ? writing_ : channel_.isWriting();
+}
+
+void TcpConnection::enableWriting() {
+    if (edgeTriggered_) {
+        writing_ = true;
+    } else {
+        channel_.enableWriting();
+    }
+}
+
+void TcpConnection::disableWriting() {
+    if (edgeTriggered_) {
+        writing_ = false;
+    } else {
+        channel_.disableWriting();
+    }
+}
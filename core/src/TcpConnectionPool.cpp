@@ -0,0 +1,170 @@
+#include "TcpConnectionPool.h"
+
+#include <algorithm>
+
+#include "Connector.h"
+#include "EventLoop.h"
+#include "LogMacros.h"
+#include "Socket.h"
+#include "TcpConnection.h"
+
+static const size_t kDefaultMaxIdlePerKey = 8;
+
+static void discardMessage(const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+    buf->retrieveAll();  // 空闲连接上的数据（如迟到的响应）直接丢弃
+}
+
+TcpConnectionPool::TcpConnectionPool(EventLoop* loop, const std::string& nameArg) :
+    loop_(loop),
+    name_(nameArg),
+    connNamePrefix_(std::make_shared<const std::string>(nameArg)),
+    nextConnId_(1),
+    maxIdlePerKey_(kDefaultMaxIdlePerKey),
+    idleTimeout_(0.0),
+    connectTimeout_(0.0),
+    initRetryDelay_(0.1),
+    maxRetryDelay_(1.0),
+    maxAttempts_(1),
+    alive_(std::make_shared<int>(0)) {}
+
+TcpConnectionPool::~TcpConnectionPool() {
+    if (expireTimer_.valid()) {
+        loop_->cancel(expireTimer_);
+    }
+    for (auto& [raw, connector] : pending_) {
+        connector->stop();
+    }
+    // 池先于连接销毁：关闭回调不能再引用 this
+    EventLoop* loop = loop_;
+    for (auto& [raw, conn] : live_) {
+        conn->setCloseCallback([loop](const TcpConnectionPtr& c) { loop->queueInLoop([c] { c->connectDestroyed(); }); });
+        conn->forceClose();
+    }
+}
+
+void TcpConnectionPool::setIdleTimeout(double seconds) {
+    idleTimeout_ = seconds;
+    if (expireTimer_.valid()) {
+        loop_->cancel(expireTimer_);
+        expireTimer_ = TimerId();
+    }
+    if (idleTimeout_ > 0.0) {
+        // 以超时的一半为周期扫描，空闲连接最晚在 1.5 倍超时内被关闭
+        expireTimer_ = loop_->runEvery(std::max(idleTimeout_ / 2, 0.1), [this] { expireIdle(); });
+    }
+}
+
+size_t TcpConnectionPool::idleCount() const {
+    size_t n = 0;
+    for (const auto& [key, list] : idle_) {
+        n += list.size();
+    }
+    return n;
+}
+
+void TcpConnectionPool::acquire(const InetAddress& addr, AcquireCallback cb) {
+    auto it = idle_.find(addr.toIpPort());
+    if (it != idle_.end()) {
+        IdleList& list = it->second;
+        while (!list.empty()) {
+            TcpConnectionPtr conn = std::move(list.back().conn);
+            list.pop_back();
+            if (conn->connected()) {
+                cb(conn);
+                return;
+            }
+        }
+    }
+
+    auto connector = std::make_shared<Connector>(loop_, addr);
+    Connector* raw = connector.get();
+    connector->setConnectTimeout(connectTimeout_);
+    connector->setRetryDelay(initRetryDelay_, maxRetryDelay_);
+    connector->setMaxAttempts(maxAttempts_);
+    connector->setNewConnectionCallback([this, raw, cb](int sockfd) { newConnection(raw, sockfd, cb); });
+    connector->setConnectFailedCallback([this, raw, cb] { connectFailed(raw, cb); });
+    pending_[raw] = connector;
+    connector->start();
+}
+
+void TcpConnectionPool::release(const TcpConnectionPtr& conn) {
+    if (!conn->connected() || live_.find(conn.get()) == live_.end()) {
+        return;  // 已断开（关闭回调负责清理）或不属于本池
+    }
+    IdleList& list = idle_[conn->peerAddress().toIpPort()];
+    if (list.size() >= maxIdlePerKey_) {
+        conn->forceClose();  // 超过空闲上限
+        return;
+    }
+    list.push_back(IdleConnection{conn, loop_->now()});
+
+    // release 常在该连接的消息回调中调用，不能就地替换正在执行的回调；
+    // 延后到本轮回调结束后，且连接仍空闲（未被再次借出）时才恢复为丢弃数据
+    std::weak_ptr<void> alive = alive_;
+    loop_->queueInLoop([this, alive, weakConn = std::weak_ptr<TcpConnection>(conn)] {
+        TcpConnectionPtr idleConn = weakConn.lock();
+        if (alive.expired() || !idleConn || !isIdle(idleConn)) {
+            return;
+        }
+        idleConn->setMessageCallback(discardMessage);
+        idleConn->setWriteCompleteCallback(WriteCompleteCallback());
+    });
+}
+
+bool TcpConnectionPool::isIdle(const TcpConnectionPtr& conn) const {
+    auto it = idle_.find(conn->peerAddress().toIpPort());
+    if (it == idle_.end()) {
+        return false;
+    }
+    return std::any_of(it->second.begin(), it->second.end(), [&conn](const IdleConnection& idle) { return idle.conn == conn; });
+}
+
+void TcpConnectionPool::newConnection(Connector* connector, int sockfd, const AcquireCallback& cb) {
+    dropConnector(connector);
+
+    auto conn = std::allocate_shared<TcpConnection>(SlabAllocator<TcpConnection>(loop_->connectionSlab()), loop_, nextConnId_++, connNamePrefix_, sockfd, Socket::getLocalAddr(sockfd), Socket::getPeerAddr(sockfd));
+    conn->applySocketOptions(SocketOptions());  // 默认开启 NODELAY 与 keepalive
+    conn->setConnectionCallback([](const TcpConnectionPtr&) {});
+    conn->setMessageCallback(discardMessage);
+    conn->setCloseCallback([this](const TcpConnectionPtr& c) { removeConnection(c); });
+    live_[conn.get()] = conn;
+    conn->connectEstablished();
+    cb(conn);
+}
+
+void TcpConnectionPool::connectFailed(Connector* connector, const AcquireCallback& cb) {
+    LOG_WARN("TcpConnectionPool [{}] connect to {} failed", name_, connector->serverAddress().toIpPort());
+    dropConnector(connector);
+    cb(nullptr);
+}
+
+void TcpConnectionPool::dropConnector(Connector* connector) {
+    auto it = pending_.find(connector);
+    if (it != pending_.end()) {
+        // 当前正处于该 Connector 的回调中，延后到本轮回调结束后再释放
+        loop_->queueInLoop([connector = std::move(it->second)] {});
+        pending_.erase(it);
+    }
+}
+
+void TcpConnectionPool::removeConnection(const TcpConnectionPtr& conn) {
+    auto it = idle_.find(conn->peerAddress().toIpPort());
+    if (it != idle_.end()) {
+        IdleList& list = it->second;
+        list.erase(std::remove_if(list.begin(), list.end(), [&conn](const IdleConnection& idle) { return idle.conn == conn; }), list.end());
+    }
+    live_.erase(conn.get());
+    loop_->queueInLoop([conn] { conn->connectDestroyed(); });
+}
+
+void TcpConnectionPool::expireIdle() {
+    MonoTimestamp now = loop_->now();
+    for (auto& [key, list] : idle_) {
+        // 列表按归还时间递增，过期的连接集中在前部
+        auto firstAlive = std::find_if(list.begin(), list.end(), [&](const IdleConnection& idle) { return timeDifference(now, idle.since) < idleTimeout_; });
+        for (auto it = list.begin(); it != firstAlive; ++it) {
+            it->conn->forceClose();  // 关闭回调会再次访问 idle_，此处只发起关闭
+        }
+        list.erase(list.begin(), firstAlive);
+    }
+}
@@ -2,6 +2,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <functional>
 
 #include "LogMacros.h"
@@ -17,24 +18,103 @@ EventLoop* CheckLoopNotNull(EventLoop* loop) {
 }  // namespace
 
 TcpServer::TcpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& nameArg, Option option) :
+    TcpServer(loop, nameArg, option, listenAddr.toIpPort()) {
+    addMainAcceptor(std::make_shared<Acceptor>(loop_, listenAddr, option_ != kNoReusePort));
+}
+
+TcpServer::TcpServer(EventLoop* loop, int listenFd, const std::string& nameArg, Option option) :
+    TcpServer(loop, nameArg, option, Socket::getLocalAddr(listenFd).toIpPort()) {
+    addMainAcceptor(std::make_shared<Acceptor>(loop_, listenFd));
+}
+
+TcpServer::TcpServer(EventLoop* loop, const std::string& nameArg, Option option, const std::string& ipPort) :
     loop_(CheckLoopNotNull(loop)),
-    ipPort_(listenAddr.toIpPort()),
+    ipPort_(ipPort),
     name_(nameArg),
-    acceptor_(new Acceptor(loop, listenAddr, option == kReusePort)),
+    connNamePrefix_(std::make_shared<const std::string>(nameArg + "-" + ipPort_)),
     threadPool_(new EventLoopThreadPool(loop, name_)),
     nextConnId_(1),
+    option_(option),
+    steering_(kSteerHash),
     started_(0),
+    idleTimeout_(0.0),
+    headerReadTimeout_(0.0),
+    writeStallTimeout_(0.0),
+    edgeTriggered_(false),
+    ioBudget_(kDefaultIoBudget),
+    busyPollMicros_(0),
+    socketBusyPollMicros_(0),
+    zeroCopyThreshold_(0),
+    backpressureHigh_(0),
+    backpressureLow_(0),
+    maxConnections_(0),
+    maxAcceptsPerEvent_(64),
+    numConnections_(0),
+    acceptPaused_(false),
+    draining_(false),
+    drainForced_(false),
     connectionCallback_(),
-    messageCallback_() {
+    messageCallback_() {}
+
+void TcpServer::addListenAddress(const InetAddress& listenAddr) {
+    if (started_ > 0) {
+        LOG_ERROR("TcpServer [{}] addListenAddress {} after start, ignored", name_, listenAddr.toIpPort());
+        return;
+    }
+    addMainAcceptor(std::make_shared<Acceptor>(loop_, listenAddr, option_ != kNoReusePort));
+}
+
+void TcpServer::addListenFd(int listenFd) {
+    if (started_ > 0) {
+        LOG_ERROR("TcpServer [{}] addListenFd {} after start, ignored", name_, listenFd);
+        return;
+    }
+    addMainAcceptor(std::make_shared<Acceptor>(loop_, listenFd));
+}
+
+std::vector<int> TcpServer::listenFds() const {
+    std::vector<int> fds;
+    for (const auto& acceptor : acceptors_) {
+        fds.push_back(acceptor->socket().getSocketFd());
+    }
+    return fds;
+}
+
+std::vector<InetAddress> TcpServer::listenAddresses() const {
+    std::vector<InetAddress> addrs;
+    for (const auto& acceptor : acceptors_) {
+        addrs.push_back(acceptor->listenAddress());
+    }
+    return addrs;
+}
+
+// 构造时即绑定地址，端口被占用等错误在启动前暴露
+void TcpServer::addMainAcceptor(std::shared_ptr<Acceptor> acceptor) {
     // 当有新用户连接时，Acceptor类中绑定的acceptChannel_会有读事件发生，执行handleRead()调用TcpServer::newConnection回调
-    acceptor_->setNewConnectionCallback([this](int sockfd, const InetAddress& listenAddr) { this->newConnection(sockfd, listenAddr); });
+    acceptor->setNewConnectionCallback([this](int sockfd, const InetAddress& peerAddr) { this->newConnection(sockfd, peerAddr); });
+    acceptor->setNewConnectionBatchCallback([this](const Acceptor::AcceptedList& accepted) { newConnectionBatch(accepted); });
+    acceptor->setAcceptQuotaCallback([this] { return acceptQuota(); });
+    acceptor->setEdgeTriggered(edgeTriggered_);
+    acceptor->setMaxAcceptsPerEvent(maxAcceptsPerEvent_);
+    acceptor->setSocketOptions(socketOptions_);
+    acceptors_.push_back(std::move(acceptor));
 }
 
 TcpServer::~TcpServer() {
-    for (auto& item : connections_) {
-        TcpConnectionPtr conn(item.second);
-        item.second.reset();  // 复位原始的智能指针，将栈空间的TcpConnectionPtr conn指向该对象，超出作用域即可释放
-        conn->getLoop()->runInLoop([conn]() { conn->connectDestroyed(); });  // 销毁连接
+    for (auto& [ioLoop, connections] : shards_) {
+        if (connections.empty()) {
+            continue;  // stop() 之后ioLoop可能已随线程退出，只有仍有连接时才需投递
+        }
+        // 整个分片移交给所属loop销毁，连接的最后一个引用随任务在该loop线程中释放
+        ioLoop->runInLoop([connections = std::move(connections)]() {
+            for (const auto& [id, conn] : connections) {
+                conn->connectDestroyed();
+            }
+        });
+    }
+    for (auto& acceptor : loopAcceptors_) {
+        // Channel须在所属loop中注销，最后一个引用随回调在该loop线程中释放
+        acceptor->getLoop()->runInLoop([acceptor] {});
     }
 }
 
@@ -44,22 +124,187 @@ void TcpServer::setThreadNum(int numThreads) {
     threadPool_->setThreadNum(numThreads_);
 }
 
+void TcpServer::setMaxAcceptsPerEvent(size_t n) {
+    maxAcceptsPerEvent_ = n;
+    for (auto& acceptor : acceptors_) {
+        acceptor->setMaxAcceptsPerEvent(n);
+    }
+}
+
+void TcpServer::setSocketOptions(const SocketOptions& opts) {
+    socketOptions_ = opts;
+    for (auto& acceptor : acceptors_) {
+        acceptor->setSocketOptions(opts);
+    }
+}
+
+void TcpServer::setEdgeTriggered(bool on, size_t ioBudget) {
+    edgeTriggered_ = on;
+    ioBudget_ = ioBudget;
+    for (auto& acceptor : acceptors_) {
+        acceptor->setEdgeTriggered(on);
+    }
+    for (auto& acceptor : loopAcceptors_) {
+        acceptor->setEdgeTriggered(on);
+    }
+}
+
 // 开启服务器监听
 void TcpServer::start() {
     if (started_.fetch_add(1) == 0) {  // 防止一个TcpServer对象被start多次
         threadPool_->start(threadInitCallback_);  // 启动底层的loop线程池
-        loop_->runInLoop([this] {  // 依赖TcpServer对象保持存活
-            acceptor_->listen();
+        for (EventLoop* ioLoop : threadPool_->getAllLoops()) {
+            shards_[ioLoop];  // 先建好全部分片，之后各loop并发读取 shards_ 无需加锁
+        }
+        if (busyPollMicros_ > 0) {
+            for (EventLoop* ioLoop : threadPool_->getAllLoops()) {
+                ioLoop->setBusyPoll(busyPollMicros_);
+            }
+        }
+        if (!mainLoopCpus_.empty()) {
+            loop_->runInLoop([this] {
+                if (!CurrentThread::setAffinity(mainLoopCpus_)) {
+                    LOG_WARN("TcpServer [{}] set main loop cpu affinity failed: {}", name_, errno);
+                }
+            });
+        }
+        bool perLoop = option_ == kReusePortPerLoop && threadPool_->getAllLoops().front() != loop_;
+        if (perLoop) {
+            startLoopAcceptors();  // IP地址的主loop acceptor保持绑定但不监听
+        }
+        loop_->runInLoop([this, perLoop] {  // 依赖TcpServer对象保持存活
+            for (auto& acceptor : acceptors_) {
+                // Unix 域地址无法按loop分流、接管的监听套接字已有排队连接，二者仍由主loop接收
+                if (!perLoop || acceptor->listenAddress().isUnix() || acceptor->adopted()) {
+                    acceptor->listen();
+                }
+            }
+        });
+    }
+}
+
+// 每个subloop一个监听套接字：内核在reuseport组内分流，accept与后续读写都在同一线程，无跨线程投递
+// 多个监听地址时每个IP地址各成一个reuseport组
+void TcpServer::startLoopAcceptors() {
+    std::vector<EventLoop*> loops = threadPool_->getAllLoops();
+    for (const auto& mainAcceptor : acceptors_) {
+        const InetAddress& listenAddr = mainAcceptor->listenAddress();
+        if (listenAddr.isUnix() || mainAcceptor->adopted()) {
+            continue;
+        }
+        size_t groupBegin = loopAcceptors_.size();
+        for (size_t i = 0; i < loops.size(); ++i) {
+            EventLoop* ioLoop = loops[i];
+            auto acceptor = std::make_shared<Acceptor>(ioLoop, listenAddr, true);
+            acceptor->setEdgeTriggered(edgeTriggered_);
+            acceptor->setMaxAcceptsPerEvent(maxAcceptsPerEvent_);
+            acceptor->setSocketOptions(socketOptions_);
+            acceptor->setAcceptQuotaCallback([this] { return acceptQuota(); });
+            acceptor->setNewConnectionBatchCallback([this, ioLoop](const Acceptor::AcceptedList& accepted) {
+                for (const Acceptor::AcceptedConnection& item : accepted) {
+                    newConnectionInLoop(ioLoop, item.sockfd, item.peerAddr);
+                }
+            });
+            if (steering_ == kSteerIncomingCpu) {
+                int cpu = threadPool_->cpuOf(i);
+                acceptor->socket().setIncomingCpu(cpu >= 0 ? cpu : static_cast<int>(i));
+            }
+            acceptor->listen();  // 在当前线程按顺序listen，保证组内序号与loop序号一致
+            loopAcceptors_.push_back(std::move(acceptor));
+        }
+        if (steering_ == kSteerCbpfCpu && !loopAcceptors_[groupBegin]->socket().attachReusePortCpuSteering(static_cast<unsigned>(loops.size()))) {
+            LOG_WARN("TcpServer [{}] cBPF steering unavailable on {}, fallback to hash", name_, listenAddr.toIpPort());
+        }
+        LOG_INFO("TcpServer [{}] listening on {} with {} reuseport acceptors", name_, listenAddr.toIpPort(), loops.size());
+    }
+}
+
+void TcpServer::drain(double timeoutSeconds, DrainCallback doneCb, bool listenFdsHandedOver) {
+    loop_->runInLoop([this, timeoutSeconds, doneCb = std::move(doneCb), listenFdsHandedOver]() mutable {
+        if (draining_.exchange(true)) {
+            return;  // 已在排空中
+        }
+        drainDoneCallback_ = std::move(doneCb);
+        drainDeadline_ = addTime(MonoTimestamp::now(), timeoutSeconds);
+        LOG_INFO("TcpServer [{}] draining {} connections, timeout {}s", name_, numConnections(), timeoutSeconds);
+        if (started_ > 0) {
+            closeAcceptors(listenFdsHandedOver);
+            forEachConnection([this](const TcpConnectionPtr& conn) { drainConnection(conn); });
+        }
+        drainTimer_ = loop_->runEvery(kDrainCheckInterval, [this] { checkDrain(); });
+    });
+}
+
+void TcpServer::forEachConnection(const ConnectionCallback& fn) {
+    for (auto& [ioLoop, connections] : shards_) {
+        EventLoop* shardLoop = ioLoop;
+        shardLoop->runInLoop([this, shardLoop, fn] {
+            // fn 可能关闭连接并修改分片，先取快照
+            std::vector<TcpConnectionPtr> conns;
+            for (const auto& [id, conn] : shards_.find(shardLoop)->second) {
+                conns.push_back(conn);
+            }
+            for (const TcpConnectionPtr& conn : conns) {
+                fn(conn);
+            }
         });
     }
 }
 
+void TcpServer::drainConnection(const TcpConnectionPtr& conn) {
+    if (connectionDrainCallback_) {
+        connectionDrainCallback_(conn);
+    } else {
+        conn->shutdown();  // 已排队的输出发完后关闭写端，等对端关闭
+    }
+}
+
+void TcpServer::checkDrain() {
+    size_t remaining = numConnections();
+    if (remaining == 0) {
+        finishDrain();
+    } else if (loop_->now() < drainDeadline_) {
+        LOG_DEBUG("TcpServer [{}] draining, {} connections remaining", name_, remaining);
+    } else if (!drainForced_) {
+        drainForced_ = true;
+        LOG_WARN("TcpServer [{}] drain timeout, force closing {} connections", name_, remaining);
+        forEachConnection([](const TcpConnectionPtr& conn) { conn->forceClose(); });
+    } else {
+        finishDrain();  // 强制关闭后已等待一个检查周期
+    }
+}
+
+void TcpServer::finishDrain() {
+    loop_->cancel(drainTimer_);
+    drainTimer_ = TimerId();
+    LOG_INFO("TcpServer [{}] drain finished, {} connections remaining", name_, numConnections());
+    DrainCallback cb = std::move(drainDoneCallback_);
+    if (cb) {
+        cb();
+    } else {
+        stop();
+    }
+}
+
 void TcpServer::stop() {
+    // 各loop的监听套接字须在所属loop中注销：注销与退出放在同一任务中，保证在loop退出前执行，
+    // 之后析构时不再向已退出的loop投递
+    // 多个监听地址时一个loop持有多个acceptor，按loop归并后只投递一个任务
+    std::unordered_map<EventLoop*, std::vector<std::shared_ptr<Acceptor>>> quitByTask;
+    for (auto& acceptor : loopAcceptors_) {
+        quitByTask[acceptor->getLoop()].push_back(std::move(acceptor));
+    }
+    loopAcceptors_.clear();
+    for (auto& [ioLoop, acceptors] : quitByTask) {
+        ioLoop->queueInLoop([ioLoop, acceptors = std::move(acceptors)]() mutable {
+            acceptors.clear();
+            ioLoop->quit();
+        });
+    }
     if (threadPool_) {
         for (auto* loop : threadPool_->getAllLoops()) {
-            if (loop) {
-                loop->quit();
-                loop->wakeup(); // 唤醒每个子 EventLoop
+            if (loop && !quitByTask.contains(loop)) {
+                loop->quit();  // 跨线程时quit内部会唤醒子 EventLoop；之后loop可能已随线程销毁，不能再访问
             }  
         }
     }
@@ -71,46 +316,149 @@ void TcpServer::stop() {
 // 将mainLoop接收到的强求连接通过回调轮询分发给subLoop
 void TcpServer::newConnection(int sockfd, const InetAddress& peerAddr) {
     // 轮询算法：选择一个subLoop来管理connfd对应的channel
-    EventLoop* ioLoop = threadPool_->getNextLoop();
+    newConnectionInLoop(threadPool_->getNextLoop(), sockfd, peerAddr);
+}
+
+// 一次可读事件接受的一批连接：按目标subloop分组，每个subloop只投递一次建立任务
+void TcpServer::newConnectionBatch(const Acceptor::AcceptedList& accepted) {
+    std::vector<std::pair<EventLoop*, std::vector<TcpConnectionPtr>>> groups;
+    for (const Acceptor::AcceptedConnection& item : accepted) {
+        EventLoop* ioLoop = threadPool_->getNextLoop();
+        TcpConnectionPtr conn = createConnection(ioLoop, item.sockfd, item.peerAddr);
+        auto it = std::find_if(groups.begin(), groups.end(), [ioLoop](const auto& group) { return group.first == ioLoop; });
+        if (it == groups.end()) {
+            groups.emplace_back(ioLoop, std::vector<TcpConnectionPtr>{});
+            it = groups.end() - 1;
+        }
+        it->second.push_back(std::move(conn));
+    }
+    for (auto& [ioLoop, conns] : groups) {
+        ioLoop->runInLoop([this, conns = std::move(conns)] {
+            for (const TcpConnectionPtr& conn : conns) {
+                connectEstablishedInLoop(conn);
+            }
+        });
+    }
+}
 
-    // ++nextConnId_;  // 没有设置为原子类是因为其只在mainloop中执行，不存在线程安全问题
-    int connId = nextConnId_.fetch_add(1, std::memory_order_relaxed);  // 即使如此依然需要全部采取原子操作保持一致性
-    char buf[64] = {0};
-    snprintf(buf, sizeof buf, "-%s#%d", ipPort_.c_str(), connId);  // 注意：通过load()方法获取原子变量的值
-    std::string connName = name_ + buf;
-    LOG_INFO("TcpServer::newConnection [{}] - new connection [{}] from {}", name_, connName, peerAddr.toIpPort());
+// 主loop接收时在主loop中调用；kReusePortPerLoop 模式下在 ioLoop 自身中调用
+void TcpServer::newConnectionInLoop(EventLoop* ioLoop, int sockfd, const InetAddress& peerAddr) {
+    TcpConnectionPtr conn = createConnection(ioLoop, sockfd, peerAddr);
+    // ioLoop->runInLoop(std::bind(&TcpConnection::connectEstablished, conn));
+    ioLoop->runInLoop([this, conn]() { connectEstablishedInLoop(conn); });
+}
 
-    sockaddr_in local;
-    socklen_t addrLen = sizeof(local);
-    ::memset(&local, 0, addrLen);
-    if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&local), &addrLen) < 0) {
-        LOG_ERROR("socket::getLocalAddr");
+void TcpServer::connectEstablishedInLoop(const TcpConnectionPtr& conn) {
+    shards_.find(conn->getLoop())->second.emplace(conn->id(), conn);
+    conn->connectEstablished();
+    if (draining_) {
+        drainConnection(conn);  // 排空开始前已accept、刚完成建立的连接
     }
-    InetAddress localAddr(local);
-    TcpConnectionPtr conn(new TcpConnection(ioLoop, connName, sockfd, localAddr, peerAddr));
-    connections_[connName] = conn;
+}
 
+TcpConnectionPtr TcpServer::createConnection(EventLoop* ioLoop, int sockfd, const InetAddress& peerAddr) {
+    // 连接数达到上限：暂停所有acceptor，新连接留在内核队列中
+    size_t count = numConnections_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (maxConnections_ > 0 && count >= maxConnections_ && !acceptPaused_.exchange(true)) {
+        LOG_WARN("TcpServer [{}] reached {} connections, pause accepting", name_, count);
+        setAccepting(false);
+        // 移除在其他loop中并发进行：暂停前若已有连接关闭且错过了恢复，这里补上
+        if (numConnections_.load(std::memory_order_relaxed) < maxConnections_ && !draining_ && acceptPaused_.exchange(false)) {
+            setAccepting(true);
+        }
+    }
+
+    // kReusePortPerLoop 模式下多个loop并发创建连接，ID生成器需为原子变量
+    uint64_t connId = nextConnId_.fetch_add(1, std::memory_order_relaxed);
+    LOG_INFO("TcpServer::newConnection [{}] - new connection #{} from {}", name_, connId, peerAddr.toIpPort());
+
+    InetAddress localAddr = Socket::getLocalAddr(sockfd);
+    // 从ioLoop的内存池分配：控制块与连接同块，连接销毁后块回到该loop的池中
+    TcpConnectionPtr conn = std::allocate_shared<TcpConnection>(SlabAllocator<TcpConnection>(ioLoop->connectionSlab()), ioLoop, connId, connNamePrefix_, sockfd, localAddr, peerAddr);
+
+    conn->applySocketOptions(socketOptions_);
     // 设置回调函数：TcpServer => TcpConnection
     conn->setConnectionCallback(connectionCallback_);
     conn->setMessageCallback(messageCallback_);
     conn->setWriteCompleteCallback(writeCompleteCallback_);
+    conn->setIdleTimeout(idleTimeout_);
+    conn->setReadTimeout(headerReadTimeout_);
+    conn->setWriteStallTimeout(writeStallTimeout_);
+    conn->setEdgeTriggered(edgeTriggered_, ioBudget_);
+    if (socketBusyPollMicros_ > 0) {
+        conn->setBusyPoll(socketBusyPollMicros_);
+    }
+    if (zeroCopyThreshold_ > 0 && !localAddr.isUnix()) {  // Unix 域套接字不支持 MSG_ZEROCOPY
+        conn->setZeroCopy(zeroCopyThreshold_);
+    }
+    if (backpressureHigh_ > 0 || outputBudget_) {
+        conn->setOutputBackpressure(backpressureHigh_, backpressureLow_, outputBudget_);
+    }
 
     // 设置关闭连接的回调
     // conn->setCloseCallback(std::bind(&TcpServer::removeConnection, this, std::placeholders::_1));
     conn->setCloseCallback([this](const TcpConnectionPtr& conn) { removeConnection(conn); });
-    // ioLoop->runInLoop(std::bind(&TcpConnection::connectEstablished, conn));
-    ioLoop->runInLoop([conn]() { conn->connectEstablished(); });
+    return conn;
 }
 
-void TcpServer::removeConnection(const TcpConnectionPtr& conn) {
-    // loop_->runInLoop(std::bind(&TcpServer::removeConnectionInLoop, this, conn));
-    loop_->runInLoop([this, conn]() { this->removeConnectionInLoop(conn); });
+size_t TcpServer::acceptQuota() const {
+    if (maxConnections_ == 0) {
+        return SIZE_MAX;
+    }
+    size_t count = numConnections_.load(std::memory_order_relaxed);
+    return count >= maxConnections_ ? 0 : maxConnections_ - count;
 }
 
-void TcpServer::removeConnectionInLoop(const TcpConnectionPtr& conn) {
-    LOG_INFO("TcpServer::removeConnectionInLoop [{}] - connection {}", name_, conn->name());
-    connections_.erase(conn->name());
+void TcpServer::setAccepting(bool on) {
+    for (Acceptor* acceptor : allAcceptors()) {
+        if (on) {
+            acceptor->resume();
+        } else {
+            acceptor->pause();
+        }
+    }
+}
+
+// 未交出的监听套接字立即关闭，新连接被内核拒绝而不是在队列中等到排空结束才被重置；
+// 已交给新进程的主loop监听套接字与其共享，只暂停accept，队列中的连接由新进程接收
+void TcpServer::closeAcceptors(bool keepMainAcceptors) {
+    setAccepting(false);  // 销毁任务执行前不再accept
+    std::vector<std::shared_ptr<Acceptor>> closing = std::move(loopAcceptors_);
+    loopAcceptors_.clear();
+    if (!keepMainAcceptors) {
+        closing.insert(closing.end(), acceptors_.begin(), acceptors_.end());
+        acceptors_.clear();
+    }
+    for (auto& acceptor : closing) {
+        // 可能正处于 Acceptor::handleRead 中，Channel须在所属loop中注销，最后一个引用随任务释放
+        EventLoop* acceptorLoop = acceptor->getLoop();
+        acceptorLoop->queueInLoop([acceptor = std::move(acceptor)] {});
+    }
+    LOG_INFO("TcpServer [{}] closed {} listen sockets for draining", name_, closing.size());
+}
+
+// 未监听的acceptor（kReusePortPerLoop 模式下主loop绑定的IP地址）暂停/恢复无副作用
+std::vector<Acceptor*> TcpServer::allAcceptors() const {
+    std::vector<Acceptor*> acceptors;
+    for (const auto& acceptor : acceptors_) {
+        acceptors.push_back(acceptor.get());
+    }
+    for (const auto& acceptor : loopAcceptors_) {
+        acceptors.push_back(acceptor.get());
+    }
+    return acceptors;
+}
+
+// 关闭回调由连接所属loop调用：从本loop分片移除后直接在本loop销毁，不再经主loop中转
+void TcpServer::removeConnection(const TcpConnectionPtr& conn) {
     EventLoop* ioLoop = conn->getLoop();
+    LOG_INFO("TcpServer::removeConnection [{}] - connection #{}", name_, conn->id());
+    shards_.find(ioLoop)->second.erase(conn->id());
+    size_t count = numConnections_.fetch_sub(1, std::memory_order_relaxed) - 1;
+    if (count < maxConnections_ && !draining_ && acceptPaused_.exchange(false)) {
+        LOG_INFO("TcpServer [{}] connections dropped to {}, resume accepting", name_, count);
+        setAccepting(true);  // Acceptor::resume 会投递到acceptor所属loop
+    }
     // ioLoop->queueInLoop(std::bind(&TcpConnection::connectDestroyed, conn));
     ioLoop->queueInLoop([conn] { conn->connectDestroyed(); });
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <future>
 
 #include "CurrentThread.h"
+#include "LogMacros.h"
 
 std::atomic_int Thread::numCreated_(0);
 
@@ -25,6 +26,10 @@ void Thread::start() {
     auto tidFuture = tidPromise.get_future();
     thread_ = std::make_shared<std::thread>([this, promise = std::move(tidPromise)] () mutable {
         tid_ = CurrentThread::tid();
+        CurrentThread::setName(name_);
+        if (!CurrentThread::setAffinity(cpus_)) {  // 先绑核再执行func_，保证其分配的内存位于本地节点
+            LOG_WARN("Thread {} set cpu affinity failed: {}", name_, errno);
+        }
         promise.set_value(tid_);
         func_();
     });
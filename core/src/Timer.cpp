@@ -0,0 +1,14 @@
+#include "Timer.h"
+
+std::atomic<int64_t> Timer::numCreated_(0);
+
+Timer::Timer(TimerCallback cb, MonoTimestamp when, double interval) :
+    callback_(std::move(cb)), expiration_(when), interval_(interval), repeat_(interval > 0.0), sequence_(++numCreated_) {}
+
+void Timer::restart(MonoTimestamp now) {
+    if (repeat_) {
+        expiration_ = addTime(now, interval_);
+    } else {
+        expiration_ = MonoTimestamp::invalid();
+    }
+}
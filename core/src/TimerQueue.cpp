@@ -0,0 +1,163 @@
+#include "TimerQueue.h"
+
+#include <string.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <iterator>
+
+#include "EventLoop.h"
+#include "LogMacros.h"
+#include "Timer.h"
+
+namespace {
+// 创建非阻塞 timerfd，使用单调时钟避免系统时间跳变影响触发
+int createTimerfd() {
+    int timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerfd < 0) {
+        LOG_FATAL("timerfd_create error:{}", errno);
+    }
+    return timerfd;
+}
+
+// 计算从现在到 when 的相对时间，最小100微秒，避免 it_value 为0导致定时器被关闭
+struct timespec howMuchTimeFromNow(MonoTimestamp when) {
+    int64_t microseconds = microsDifference(when, MonoTimestamp::now());
+    if (microseconds < 100) {
+        microseconds = 100;
+    }
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(microseconds / Timestamp::kMicroSecondsPerSecond);
+    ts.tv_nsec = static_cast<long>((microseconds % Timestamp::kMicroSecondsPerSecond) * 1000);
+    return ts;
+}
+
+// 读走 timerfd 的到期计数，否则 LT 模式下会持续触发
+void readTimerfd(int timerfd) {
+    uint64_t howmany = 0;
+    ssize_t n = ::read(timerfd, &howmany, sizeof howmany);
+    if (n != sizeof howmany) {
+        LOG_ERROR("TimerQueue::handleRead() reads {} bytes instead of 8", n);
+    }
+}
+
+// 将 timerfd 的下次触发时间设置为 expiration
+void resetTimerfd(int timerfd, MonoTimestamp expiration) {
+    struct itimerspec newValue;
+    ::memset(&newValue, 0, sizeof newValue);
+    newValue.it_value = howMuchTimeFromNow(expiration);
+    if (::timerfd_settime(timerfd, 0, &newValue, nullptr) != 0) {
+        LOG_ERROR("timerfd_settime error:{}", errno);
+    }
+}
+}  // namespace
+
+TimerQueue::TimerQueue(EventLoop* loop) :
+    loop_(loop),
+    timerfd_(createTimerfd()),
+    timerfdChannel_(loop, timerfd_),
+    timers_(),
+    callingExpiredTimers_(false) {
+    timerfdChannel_.setReadCallback([this](Timestamp) { handleRead(); });
+    timerfdChannel_.enableReading();  // 始终监听 timerfd，由 timerfd_settime 控制触发时机
+}
+
+TimerQueue::~TimerQueue() {
+    timerfdChannel_.disableAll();
+    timerfdChannel_.remove();
+    ::close(timerfd_);
+    for (const Entry& timer : timers_) {
+        delete timer.second;
+    }
+}
+
+TimerId TimerQueue::addTimer(TimerCallback cb, MonoTimestamp when, double interval) {
+    Timer* timer = new Timer(std::move(cb), when, interval);
+    loop_->runInLoop([this, timer] { addTimerInLoop(timer); });
+    return TimerId(timer, timer->sequence());
+}
+
+void TimerQueue::cancel(TimerId timerId) {
+    loop_->runInLoop([this, timerId] { cancelInLoop(timerId); });
+}
+
+void TimerQueue::addTimerInLoop(Timer* timer) {
+    bool earliestChanged = insert(timer);
+    if (earliestChanged) {
+        resetTimerfd(timerfd_, timer->expiration());  // 新定时器最早到期，需要重设 timerfd
+    }
+}
+
+void TimerQueue::cancelInLoop(TimerId timerId) {
+    ActiveTimer timer(timerId.timer_, timerId.sequence_);
+    auto it = activeTimers_.find(timer);
+    if (it != activeTimers_.end()) {
+        timers_.erase(Entry(it->first->expiration(), it->first));
+        delete it->first;
+        activeTimers_.erase(it);
+    } else if (callingExpiredTimers_) {
+        // 定时器正在回调中（已从集合中取出），记录下来防止周期定时器被重新插入
+        cancelingTimers_.insert(timer);
+    }
+}
+
+void TimerQueue::handleRead() {
+    MonoTimestamp now(MonoTimestamp::now());
+    readTimerfd(timerfd_);
+
+    std::vector<Entry> expired = getExpired(now);
+
+    callingExpiredTimers_ = true;
+    cancelingTimers_.clear();
+    for (const Entry& it : expired) {
+        loop_->recordTimerLag(microsDifference(now, it.first));  // 到期到开始分发的延迟
+        it.second->run();
+    }
+    callingExpiredTimers_ = false;
+
+    reset(expired, now);
+}
+
+std::vector<TimerQueue::Entry> TimerQueue::getExpired(MonoTimestamp now) {
+    std::vector<Entry> expired;
+    Entry sentry(now, reinterpret_cast<Timer*>(UINTPTR_MAX));
+    auto end = timers_.lower_bound(sentry);  // 第一个未到期的定时器
+    std::copy(timers_.begin(), end, std::back_inserter(expired));
+    timers_.erase(timers_.begin(), end);
+
+    for (const Entry& it : expired) {
+        activeTimers_.erase(ActiveTimer(it.second, it.second->sequence()));
+    }
+    return expired;
+}
+
+void TimerQueue::reset(const std::vector<Entry>& expired, MonoTimestamp now) {
+    for (const Entry& it : expired) {
+        ActiveTimer timer(it.second, it.second->sequence());
+        if (it.second->repeat() && cancelingTimers_.find(timer) == cancelingTimers_.end()) {
+            it.second->restart(now);
+            insert(it.second);
+        } else {
+            delete it.second;
+        }
+    }
+
+    if (!timers_.empty()) {
+        MonoTimestamp nextExpire = timers_.begin()->second->expiration();
+        if (nextExpire.valid()) {
+            resetTimerfd(timerfd_, nextExpire);
+        }
+    }
+}
+
+bool TimerQueue::insert(Timer* timer) {
+    bool earliestChanged = false;
+    MonoTimestamp when = timer->expiration();
+    auto it = timers_.begin();
+    if (it == timers_.end() || when < it->first) {
+        earliestChanged = true;
+    }
+    timers_.insert(Entry(when, timer));
+    activeTimers_.insert(ActiveTimer(timer, timer->sequence()));
+    return earliestChanged;
+}
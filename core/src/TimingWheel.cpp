@@ -0,0 +1,165 @@
+#include "TimingWheel.h"
+
+#include <cmath>
+
+#include "EventLoop.h"
+
+namespace {
+// 将 src 链表整体接到 dst（空）哨兵上，并清空 src
+template <typename Link>
+void spliceList(Link* dst, Link* src) {
+    if (src->next == src) {
+        dst->next = dst->prev = dst;
+        return;
+    }
+    dst->next = src->next;
+    dst->prev = src->prev;
+    dst->next->prev = dst;
+    dst->prev->next = dst;
+    src->next = src->prev = src;
+}
+}  // namespace
+
+void TimingWheel::Entry::unlink() {
+    if (wheel_ == nullptr) {
+        return;
+    }
+    prev->next = next;
+    next->prev = prev;
+    prev = next = nullptr;
+    --wheel_->size_;
+    wheel_ = nullptr;
+}
+
+TimingWheel::TimingWheel(EventLoop* loop, double tickSeconds) :
+    loop_(loop), tickSeconds_(tickSeconds > 0.0 ? tickSeconds : 1.0), currentTick_(0), size_(0), ticking_(false) {
+    for (auto& level : wheels_) {
+        for (Slot& slot : level) {
+            slot.next = slot.prev = &slot;
+        }
+    }
+}
+
+TimingWheel::~TimingWheel() {
+    stopTicking();
+    // 剩余条目由各自持有者析构，这里只断开与时间轮的关联
+    for (auto& level : wheels_) {
+        for (Slot& slot : level) {
+            while (slot.next != &slot) {
+                static_cast<Entry*>(slot.next)->unlink();
+            }
+        }
+    }
+}
+
+// 当前tick已经走过一部分，多加一个tick保证实际超时不短于 timeout
+// 非正数与 NaN 按1个tick处理（下一个tick到期），避免负数或 NaN 转换为整数的未定义行为
+uint64_t TimingWheel::toTicks(double timeout) const {
+    if (!(timeout > 0.0)) {
+        return 1;
+    }
+    double ticks = std::ceil(timeout / tickSeconds_) + 1.0;
+    if (ticks > static_cast<double>(kMaxTicks)) {
+        return kMaxTicks;
+    }
+    return static_cast<uint64_t>(ticks);
+}
+
+void TimingWheel::schedule(Entry* entry, double timeout) {
+    entry->unlink();
+    entry->deadline_ = currentTick_ + toTicks(timeout);
+    entry->expire_ = entry->deadline_;
+    entry->wheel_ = this;
+    ++size_;
+    insert(entry);
+    if (!ticking_) {
+        startTicking();
+    }
+}
+
+void TimingWheel::touch(Entry* entry, double timeout) {
+    if (entry->wheel_ != this) {
+        schedule(entry, timeout);
+        return;
+    }
+    // 热路径：只推迟截止tick，节点在原槽到期时再重新挂入
+    entry->deadline_ = currentTick_ + toTicks(timeout);
+}
+
+void TimingWheel::insert(Entry* entry) {
+    uint64_t delta = entry->expire_ > currentTick_ ? entry->expire_ - currentTick_ : 0;
+    if (delta > kMaxTicks) {
+        entry->expire_ = currentTick_ + kMaxTicks;  // 超出跨度先放在最远处，到期后按deadline_再挂入
+        delta = kMaxTicks;
+    }
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t{1} << ((level + 1) * kSlotBits))) {
+        ++level;
+    }
+    uint64_t index = (entry->expire_ >> (level * kSlotBits)) & kSlotMask;
+    Slot* slot = &wheels_[level][index];
+
+    entry->prev = slot->prev;
+    entry->next = slot;
+    slot->prev->next = entry;
+    slot->prev = entry;
+}
+
+void TimingWheel::cascade(int level) {
+    uint64_t index = (currentTick_ >> (level * kSlotBits)) & kSlotMask;
+    Slot pending;
+    spliceList(&pending, &wheels_[level][index]);
+    while (pending.next != &pending) {
+        Entry* entry = static_cast<Entry*>(pending.next);
+        pending.next = entry->next;
+        entry->next->prev = &pending;
+        insert(entry);
+    }
+}
+
+void TimingWheel::onTick() {
+    ++currentTick_;
+
+    // 低层转满一圈时，依次把高层对应槽下放
+    for (int level = 1; level < kLevels; ++level) {
+        if ((currentTick_ & ((uint64_t{1} << (level * kSlotBits)) - 1)) != 0) {
+            break;
+        }
+        cascade(level);
+    }
+
+    Slot expired;
+    spliceList(&expired, &wheels_[0][currentTick_ & kSlotMask]);
+    while (expired.next != &expired) {
+        Entry* entry = static_cast<Entry*>(expired.next);
+        if (entry->deadline_ > currentTick_) {
+            // 期间被 touch 过，按新的截止时间重新挂入
+            expired.next = entry->next;
+            entry->next->prev = &expired;
+            entry->expire_ = entry->deadline_;
+            insert(entry);
+            continue;
+        }
+        entry->unlink();  // 先摘除，回调中可以重新 schedule
+        if (entry->callback_) {
+            entry->callback_();
+        }
+    }
+
+    if (size_ == 0) {
+        stopTicking();
+    }
+}
+
+void TimingWheel::startTicking() {
+    ticking_ = true;
+    tickTimer_ = loop_->runEvery(tickSeconds_, [this] { onTick(); });
+}
+
+void TimingWheel::stopTicking() {
+    if (ticking_) {
+        loop_->cancel(tickTimer_);
+        ticking_ = false;
+    }
+}
@@ -0,0 +1,410 @@
+#include "UdpChannel.h"
+
+#include <errno.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+
+#include "EventLoop.h"
+#include "LogMacros.h"
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace {
+// 每次可读事件最多连续 recvmmsg 的批数，避免单个UDP套接字饿死同loop的其他事件
+const size_t kMaxBatchesPerEvent = 8;
+// GRO合并后的最大报文长度，开启GRO时每个接收槽位需容纳一整个合并报文，否则会被截断
+const size_t kGroSlotSize = 65535;
+// UDP_SEGMENT 限制：单个GSO报文最多64段，负载总长不超过IPv4 UDP上限
+const size_t kMaxGsoSegments = 64;
+const size_t kMaxGsoBytes = 65507;
+// 发送区中已发出部分超过该值且过半时整理一次，避免队列长期不空时发送区无限增长
+const size_t kCompactThreshold = 64 * 1024;
+
+const size_t kRecvControlSize = CMSG_SPACE(sizeof(int));
+const size_t kSendControlSize = CMSG_SPACE(sizeof(uint16_t));
+
+int createNonBlockingUdpSocket(sa_family_t family) {
+    int sockfd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (sockfd < 0) {
+        LOG_FATAL("udp socket create err:{}", errno);
+    }
+    return sockfd;
+}
+
+template <typename T>
+void add(std::atomic<T>& counter, T n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void recordBatch(std::atomic<uint64_t>& maxBatch, std::array<std::atomic<uint64_t>, UdpStats::kBatchBuckets>& histogram, uint64_t count) {
+    if (count > maxBatch.load(std::memory_order_relaxed)) {
+        maxBatch.store(count, std::memory_order_relaxed);
+    }
+    add<uint64_t>(histogram[UdpStats::batchBucket(count)], 1);
+}
+}  // namespace
+
+UdpStats& UdpStats::operator+=(const UdpStats& other) {
+    recvCalls += other.recvCalls;
+    datagramsReceived += other.datagramsReceived;
+    bytesReceived += other.bytesReceived;
+    groDatagrams += other.groDatagrams;
+    truncated += other.truncated;
+    maxRecvBatch = std::max(maxRecvBatch, other.maxRecvBatch);
+    sendCalls += other.sendCalls;
+    datagramsSent += other.datagramsSent;
+    bytesSent += other.bytesSent;
+    gsoMessages += other.gsoMessages;
+    maxSendBatch = std::max(maxSendBatch, other.maxSendBatch);
+    sendDrops += other.sendDrops;
+    sendErrors += other.sendErrors;
+    for (size_t i = 0; i < kBatchBuckets; ++i) {
+        recvBatchHistogram[i] += other.recvBatchHistogram[i];
+        sendBatchHistogram[i] += other.sendBatchHistogram[i];
+    }
+    return *this;
+}
+
+double UdpStats::avgRecvBatch() const {
+    return recvCalls == 0 ? 0.0 : static_cast<double>(datagramsReceived) / static_cast<double>(recvCalls);
+}
+
+double UdpStats::avgSendBatch() const {
+    return sendCalls == 0 ? 0.0 : static_cast<double>(datagramsSent) / static_cast<double>(sendCalls);
+}
+
+size_t UdpStats::batchBucket(uint64_t count) {
+    if (count <= 1) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(std::bit_width(count)) - 1, kBatchBuckets - 1);  // floor(log2)
+}
+
+UdpChannel::UdpChannel(EventLoop* loop, const InetAddress& bindAddr, bool reusePort, const std::string& name) :
+    loop_(loop),
+    name_(name),
+    socket_(createNonBlockingUdpSocket(bindAddr.family())),
+    channel_(loop, socket_.getSocketFd()),
+    recvBatch_(kDefaultBatch),
+    sendBatch_(kDefaultBatch),
+    datagramSize_(kDefaultDatagramSize),
+    maxQueuedBytes_(kDefaultMaxQueuedBytes),
+    groRequested_(false),
+    groEnabled_(false),
+    gsoEnabled_(true),
+    slotSize_(0),
+    sendArenaHead_(0),
+    sendQueueHead_(0),
+    plainDatagrams_(0),
+    flushQueued_(false) {
+    // 不设 SO_REUSEADDR：UDP 没有 TIME_WAIT，而它会让任意进程绑定同一地址端口、分走单播报文；
+    // SO_REUSEPORT 要求同一有效用户，只在显式要求时开启
+    socket_.setReusePort(reusePort);  // 每个loop各自绑定同一端口，内核按四元组哈希分流
+    socket_.bindAddress(bindAddr);
+    channel_.setReadCallback([this](Timestamp receiveTime) { handleRead(receiveTime); });
+    channel_.setWriteCallback([this] { handleWrite(); });
+}
+
+UdpChannel::~UdpChannel() {
+    channel_.disableAll();
+    channel_.remove();
+}
+
+void UdpChannel::start() {
+    const int fd = socket_.getSocketFd();
+    if (groRequested_) {
+        int on = 1;
+        if (::setsockopt(fd, SOL_UDP, UDP_GRO, &on, sizeof on) == 0) {
+            groEnabled_ = true;
+        } else {
+            LOG_WARN("UdpChannel [{}] UDP_GRO unsupported: {}", name_, errno);
+        }
+    }
+    slotSize_ = groEnabled_ ? kGroSlotSize : datagramSize_;
+
+    // 接收区：recvBatch_ 个槽位连续分配，mmsghdr 指向各槽位后不再变化，每批只需复位长度字段
+    recvArena_ = std::make_unique_for_overwrite<char[]>(recvBatch_ * slotSize_);
+    recvControl_ = std::make_unique<char[]>(recvBatch_ * kRecvControlSize);
+    recvMsgs_.assign(recvBatch_, mmsghdr{});
+    recvIovecs_.resize(recvBatch_);
+    recvAddrs_.resize(recvBatch_);
+    for (size_t i = 0; i < recvBatch_; ++i) {
+        recvIovecs_[i].iov_base = recvArena_.get() + i * slotSize_;
+        recvIovecs_[i].iov_len = slotSize_;
+        msghdr& hdr = recvMsgs_[i].msg_hdr;
+        hdr.msg_name = &recvAddrs_[i];
+        hdr.msg_iov = &recvIovecs_[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = groEnabled_ ? recvControl_.get() + i * kRecvControlSize : nullptr;
+    }
+    batch_.reserve(recvBatch_);
+
+    sendMsgs_.resize(sendBatch_);
+    sendIovecs_.resize(sendBatch_);
+    sendMsgDatagrams_.reserve(sendBatch_);
+    sendControl_ = std::make_unique<char[]>(sendBatch_ * kSendControlSize);
+
+    channel_.enableReading();
+    LOG_INFO("UdpChannel [{}] bound to {} batch={}/{} gro={} gso={}", name_, localAddress().toIpPort(), recvBatch_, sendBatch_, groEnabled_, gsoEnabled_);
+}
+
+void UdpChannel::handleRead(Timestamp receiveTime) {
+    const int fd = socket_.getSocketFd();
+    for (size_t round = 0; round < kMaxBatchesPerEvent; ++round) {
+        for (size_t i = 0; i < recvBatch_; ++i) {
+            msghdr& hdr = recvMsgs_[i].msg_hdr;
+            hdr.msg_namelen = sizeof(sockaddr_storage);
+            hdr.msg_controllen = groEnabled_ ? kRecvControlSize : 0;
+            hdr.msg_flags = 0;
+        }
+        int n = ::recvmmsg(fd, recvMsgs_.data(), static_cast<unsigned int>(recvBatch_), MSG_DONTWAIT, nullptr);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_ERROR("UdpChannel [{}] recvmmsg error: {}", name_, errno);
+            }
+            break;
+        }
+
+        batch_.clear();
+        size_t bytes = 0;
+        for (int i = 0; i < n; ++i) {
+            const msghdr& hdr = recvMsgs_[i].msg_hdr;
+            const size_t len = recvMsgs_[i].msg_len;
+            if (hdr.msg_flags & MSG_TRUNC) {
+                add<uint64_t>(counters_.truncated, 1);  // 截断的数据报不完整，直接丢弃
+                continue;
+            }
+            size_t segment = len;
+            if (groEnabled_) {
+                for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+                    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                        int gsoSize = 0;
+                        ::memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof gsoSize);
+                        if (gsoSize > 0) {
+                            segment = static_cast<size_t>(gsoSize);
+                        }
+                    }
+                }
+            }
+            const InetAddress peer(reinterpret_cast<const sockaddr*>(&recvAddrs_[i]), hdr.msg_namelen);
+            const char* base = static_cast<const char*>(recvIovecs_[i].iov_base);
+            const size_t before = batch_.size();
+            if (len == 0) {
+                batch_.push_back(Datagram{peer, base, 0});  // 空数据报同样交付
+            }
+            for (size_t offset = 0; offset < len; offset += segment) {
+                batch_.push_back(Datagram{peer, base + offset, std::min(segment, len - offset)});
+            }
+            if (batch_.size() - before > 1) {
+                add<uint64_t>(counters_.groDatagrams, batch_.size() - before);
+            }
+            bytes += len;
+        }
+
+        if (n > 0) {
+            add<uint64_t>(counters_.recvCalls, 1);
+            add<uint64_t>(counters_.datagramsReceived, batch_.size());
+            add<uint64_t>(counters_.bytesReceived, bytes);
+            recordBatch(counters_.maxRecvBatch, counters_.recvBatchHistogram, batch_.size());
+        }
+        if (!batch_.empty() && batchCallback_) {
+            batchCallback_(this, batch_, receiveTime);
+        }
+        if (static_cast<size_t>(n) < recvBatch_) {
+            break;  // 接收队列已读空
+        }
+    }
+}
+
+void UdpChannel::send(const InetAddress& peer, const void* data, size_t len) {
+    if (loop_->isInLoopThread()) {
+        enqueue(peer, static_cast<const char*>(data), len);
+    } else {
+        loop_->queueInLoop([self = shared_from_this(), addr = peer, copy = std::string(static_cast<const char*>(data), len)] {
+            self->enqueue(addr, copy.data(), copy.size());
+        });
+    }
+}
+
+void UdpChannel::enqueue(const InetAddress& peer, const char* data, size_t len) {
+    if (queuedBytes() + len > maxQueuedBytes_) {
+        add<uint64_t>(counters_.sendDrops, 1);  // UDP不保证送达，积压时丢弃新数据报而不是无限缓存
+        return;
+    }
+    sendQueue_.push_back(PendingDatagram{peer, sendArena_.size(), len});
+    sendArena_.insert(sendArena_.end(), data, data + len);
+    // 本轮回调中的所有发送合并到回调队列末尾一次 sendmmsg；等待可写期间由 handleWrite 负责
+    if (!flushQueued_ && !channel_.isWriting()) {
+        flushQueued_ = true;
+        loop_->queueInLoop([self = shared_from_this()] {
+            self->flushQueued_ = false;
+            self->flush();
+        });
+    }
+}
+
+size_t UdpChannel::buildSendBatch() {
+    sendMsgDatagrams_.clear();
+    size_t msgs = 0;
+    size_t i = sendQueueHead_;
+    while (msgs < sendBatch_ && i < sendQueue_.size()) {
+        PendingDatagram& first = sendQueue_[i];
+        size_t count = 1;
+        size_t bytes = first.size;
+        if (gsoEnabled_ && first.size > 0 && i - sendQueueHead_ >= plainDatagrams_) {
+            // 同一对端、等长且在发送区中相邻的后续数据报合并为一个GSO报文，内核按 first.size 切分；最后一段可以更短
+            while (i + count < sendQueue_.size() && count < kMaxGsoSegments) {
+                const PendingDatagram& next = sendQueue_[i + count];
+                if (next.peer != first.peer || next.offset != first.offset + bytes || next.size == 0 ||
+                    next.size > first.size || bytes + next.size > kMaxGsoBytes) {
+                    break;
+                }
+                bytes += next.size;
+                ++count;
+                if (next.size < first.size) {
+                    break;
+                }
+            }
+        }
+
+        iovec& iov = sendIovecs_[msgs];
+        iov.iov_base = sendArena_.data() + first.offset;
+        iov.iov_len = bytes;
+        mmsghdr& msg = sendMsgs_[msgs];
+        ::memset(&msg, 0, sizeof msg);
+        msg.msg_hdr.msg_name = const_cast<sockaddr*>(first.peer.getSockAddr());
+        msg.msg_hdr.msg_namelen = first.peer.getSockLen();
+        msg.msg_hdr.msg_iov = &iov;
+        msg.msg_hdr.msg_iovlen = 1;
+        if (count > 1) {
+            char* control = sendControl_.get() + msgs * kSendControlSize;
+            ::memset(control, 0, kSendControlSize);
+            msg.msg_hdr.msg_control = control;
+            msg.msg_hdr.msg_controllen = kSendControlSize;
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg.msg_hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const auto segmentSize = static_cast<uint16_t>(first.size);
+            ::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof segmentSize);
+        }
+        sendMsgDatagrams_.push_back(count);
+        ++msgs;
+        i += count;
+    }
+    return msgs;
+}
+
+void UdpChannel::flush() {
+    const int fd = socket_.getSocketFd();
+    while (sendQueueHead_ < sendQueue_.size()) {
+        const size_t msgs = buildSendBatch();
+        int n = ::sendmmsg(fd, sendMsgs_.data(), static_cast<unsigned int>(msgs), MSG_DONTWAIT);
+        if (n < 0) {
+            const int savedErrno = errno;
+            if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK) {
+                if (!channel_.isWriting()) {
+                    channel_.enableWriting();  // 套接字发送缓冲区满，可写后继续
+                }
+                return;
+            }
+            if (savedErrno == EINTR) {
+                continue;
+            }
+            if (sendMsgDatagrams_[0] > 1 && savedErrno == EINVAL) {
+                // 只是这一个合并报文不被接受（如超出路径MTU或设备的分段上限）：拆开逐个重发，之后的数据报照常合并
+                LOG_DEBUG("UdpChannel [{}] UDP_SEGMENT of {} datagrams rejected, resend them one by one", name_, sendMsgDatagrams_[0]);
+                plainDatagrams_ = sendMsgDatagrams_[0];
+                continue;
+            }
+            if (sendMsgDatagrams_[0] > 1 && (savedErrno == EIO || savedErrno == ENOPROTOOPT)) {
+                gsoEnabled_ = false;  // 内核或网卡不支持UDP_SEGMENT，之后逐个发送
+                LOG_WARN("UdpChannel [{}] UDP_SEGMENT failed ({}), falling back to plain sendmmsg", name_, savedErrno);
+                continue;
+            }
+            // 队首报文被拒绝（ICMP不可达、超长等）：丢弃它，继续发送后面的
+            LOG_DEBUG("UdpChannel [{}] sendmmsg error: {}", name_, savedErrno);
+            add<uint64_t>(counters_.sendErrors, sendMsgDatagrams_[0]);
+            advanceSendQueue(sendMsgDatagrams_[0]);
+            continue;
+        }
+
+        size_t datagrams = 0;
+        size_t bytes = 0;
+        for (int i = 0; i < n; ++i) {
+            datagrams += sendMsgDatagrams_[i];
+            bytes += sendIovecs_[i].iov_len;
+            if (sendMsgDatagrams_[i] > 1) {
+                add<uint64_t>(counters_.gsoMessages, 1);
+            }
+        }
+        add<uint64_t>(counters_.sendCalls, 1);
+        add<uint64_t>(counters_.datagramsSent, datagrams);
+        add<uint64_t>(counters_.bytesSent, bytes);
+        recordBatch(counters_.maxSendBatch, counters_.sendBatchHistogram, datagrams);
+        advanceSendQueue(datagrams);  // 只发出部分报文时，下一次调用会报告失败报文的错误
+    }
+    if (channel_.isWriting()) {
+        channel_.disableWriting();
+    }
+}
+
+void UdpChannel::advanceSendQueue(size_t datagrams) {
+    plainDatagrams_ -= std::min(plainDatagrams_, datagrams);
+    sendQueueHead_ += datagrams;
+    if (sendQueueHead_ >= sendQueue_.size()) {
+        sendQueue_.clear();
+        sendArena_.clear();
+        sendQueueHead_ = 0;
+        sendArenaHead_ = 0;
+        return;
+    }
+    sendArenaHead_ = sendQueue_[sendQueueHead_].offset;
+    if (sendArenaHead_ > kCompactThreshold && sendArenaHead_ > sendArena_.size() / 2) {
+        sendArena_.erase(sendArena_.begin(), sendArena_.begin() + static_cast<ptrdiff_t>(sendArenaHead_));
+        sendQueue_.erase(sendQueue_.begin(), sendQueue_.begin() + static_cast<ptrdiff_t>(sendQueueHead_));
+        for (PendingDatagram& pending : sendQueue_) {
+            pending.offset -= sendArenaHead_;
+        }
+        sendQueueHead_ = 0;
+        sendArenaHead_ = 0;
+    }
+}
+
+void UdpChannel::handleWrite() {
+    flush();
+}
+
+UdpStats UdpChannel::stats() const {
+    UdpStats stats;
+    stats.recvCalls = counters_.recvCalls.load(std::memory_order_relaxed);
+    stats.datagramsReceived = counters_.datagramsReceived.load(std::memory_order_relaxed);
+    stats.bytesReceived = counters_.bytesReceived.load(std::memory_order_relaxed);
+    stats.groDatagrams = counters_.groDatagrams.load(std::memory_order_relaxed);
+    stats.truncated = counters_.truncated.load(std::memory_order_relaxed);
+    stats.maxRecvBatch = counters_.maxRecvBatch.load(std::memory_order_relaxed);
+    stats.sendCalls = counters_.sendCalls.load(std::memory_order_relaxed);
+    stats.datagramsSent = counters_.datagramsSent.load(std::memory_order_relaxed);
+    stats.bytesSent = counters_.bytesSent.load(std::memory_order_relaxed);
+    stats.gsoMessages = counters_.gsoMessages.load(std::memory_order_relaxed);
+    stats.maxSendBatch = counters_.maxSendBatch.load(std::memory_order_relaxed);
+    stats.sendDrops = counters_.sendDrops.load(std::memory_order_relaxed);
+    stats.sendErrors = counters_.sendErrors.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < UdpStats::kBatchBuckets; ++i) {
+        stats.recvBatchHistogram[i] = counters_.recvBatchHistogram[i].load(std::memory_order_relaxed);
+        stats.sendBatchHistogram[i] = counters_.sendBatchHistogram[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
@@ -0,0 +1,70 @@
+#include "UdpServer.h"
+
+#include "LogMacros.h"
+
+UdpServer::UdpServer(EventLoop* loop, const InetAddress& bindAddr, const std::string& nameArg, Option option) :
+    loop_(loop),
+    bindAddr_(bindAddr),
+    name_(nameArg),
+    option_(option),
+    threadPool_(std::make_shared<EventLoopThreadPool>(loop, nameArg)),
+    started_(0),
+    recvBatch_(UdpChannel::kDefaultBatch),
+    sendBatch_(UdpChannel::kDefaultBatch),
+    maxDatagramSize_(UdpChannel::kDefaultDatagramSize),
+    maxQueuedBytes_(UdpChannel::kDefaultMaxQueuedBytes),
+    gro_(false),
+    gso_(true) {
+    if (loop_ == nullptr) {
+        LOG_FATAL("UdpServer [{}] mainLoop is null!", name_);
+    }
+}
+
+UdpServer::~UdpServer() {
+    for (auto& channel : channels_) {
+        // Channel须在所属loop中注销，最后一个引用随回调在该loop线程中释放
+        channel->getLoop()->runInLoop([channel = std::move(channel)] {});
+    }
+}
+
+void UdpServer::start() {
+    if (started_.fetch_add(1) != 0) {
+        return;
+    }
+    std::vector<EventLoop*> loops{loop_};
+    if (option_ == kReusePortPerLoop) {
+        threadPool_->start(threadInitCallback_);
+        loops = threadPool_->getAllLoops();
+    } else if (threadInitCallback_) {
+        threadInitCallback_(loop_);
+    }
+    for (size_t i = 0; i < loops.size(); ++i) {
+        EventLoop* ioLoop = loops[i];
+        auto channel = std::make_shared<UdpChannel>(ioLoop, bindAddr_, option_ == kReusePortPerLoop, name_ + "#" + std::to_string(i));
+        channel->setDatagramBatchCallback(batchCallback_);
+        channel->setRecvBatch(recvBatch_);
+        channel->setSendBatch(sendBatch_);
+        channel->setMaxDatagramSize(maxDatagramSize_);
+        channel->setMaxQueuedBytes(maxQueuedBytes_);
+        channel->setGro(gro_);
+        channel->setGso(gso_);
+        channels_.push_back(channel);
+        ioLoop->runInLoop([channel] { channel->start(); });
+    }
+}
+
+std::vector<UdpStats> UdpServer::channelStats() const {
+    std::vector<UdpStats> stats;
+    for (const auto& channel : channels_) {
+        stats.push_back(channel->stats());
+    }
+    return stats;
+}
+
+UdpStats UdpServer::stats() const {
+    UdpStats total;
+    for (const auto& channel : channels_) {
+        total += channel->stats();
+    }
+    return total;
+}
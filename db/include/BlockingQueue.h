@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -33,6 +34,18 @@ public:
         return true;
     }
 
+    // 限时出队；返回 false 时 *timedOut 区分超时（true）与队列已停止（false）
+    template <typename Rep, typename Period>
+    bool PopFor(T& value, const std::chrono::duration<Rep, Period>& timeout, bool* timedOut) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        *timedOut = !not_empty_.wait_for(lock, timeout, [this]() { return !queue_.empty() || stopped_; });
+        if (*timedOut || (stopped_ && queue_.empty()))
+            return false;
+        value = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
     // 停止队列，唤醒所有等待线程
     void Cancel() {
         {
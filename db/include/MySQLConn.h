@@ -5,10 +5,12 @@
 #include <cppconn/statement.h>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "BlockingQueue.h"
 #include "MySQLConnInfo.h"
@@ -49,6 +51,11 @@ public:
     MySQLWorker(std::shared_ptr<MySQLConn> conn, std::shared_ptr<BlockingQueue<std::shared_ptr<SQLOperation>>> queue);
     ~MySQLWorker();
 
+    // 工作线程绑核列表，需在 Start() 之前设置
+    void SetCpuAffinity(std::vector<int> cpus) { cpus_ = std::move(cpus); }
+    // 空闲超过该时长即 Ping 自己的连接（心跳由 worker 完成，不再单独起线程），0 表示不探测；需在 Start() 之前设置
+    void SetIdlePingInterval(std::chrono::seconds interval) { idle_ping_interval_ = interval; }
+
     void Start();
     void Stop();
 
@@ -59,4 +66,6 @@ private:
     std::shared_ptr<BlockingQueue<std::shared_ptr<SQLOperation>>> queue_;
     std::thread thread_;
     std::atomic<bool> running_{false};
+    std::vector<int> cpus_;
+    std::chrono::seconds idle_ping_interval_{0};
 };
@@ -28,6 +28,9 @@ public:
     std::future<bool> SubmitExec(const std::string&);
     std::future<int> SubmitUpdate(const std::string&);
 
+    // worker 线程绑核列表（如绑定到与网络loop同一NUMA节点的核），需在 InitPool 之前设置
+    void SetWorkerCpuAffinity(std::vector<int> cpus) { worker_cpus_ = std::move(cpus); }
+
     // 停止所有 worker 线程
     void Shutdown();
 
@@ -35,15 +38,6 @@ private:
     void CreateInitialConnections(const MySQLConnInfo& info);
     void SpawnWorkerThreads();
 
-    // ------------------ 新增：心跳检测 ------------------
-    void KeepAliveLoop();
-    void StartKeepAlive();
-    void StopKeepAlive();
-
-    std::thread keepalive_thread_;
-    std::atomic<bool> running_{false};
-    // ---------------------------------------------------
-
     std::string database_;
     std::vector<std::shared_ptr<MySQLConn>> conns_;
     std::vector<std::unique_ptr<MySQLWorker>> workers_;
@@ -53,6 +47,7 @@ private:
     int max_size_ = 0;
     int max_idle_time_ = 0;
     int connect_timeout_ = 0;
+    std::vector<int> worker_cpus_;
 
     static std::unordered_map<std::string, std::weak_ptr<MySQLConnPool>> instances_;
     static std::mutex instance_mtx_;
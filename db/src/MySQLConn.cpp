@@ -3,6 +3,7 @@
 #include <cppconn/exception.h>
 #include <cppconn/statement.h>
 
+#include "CurrentThread.h"
 #include "LogMacros.h"
 
 // ------------------ MySQLConn ------------------
@@ -131,8 +132,25 @@ void MySQLWorker::Stop() {
 }
 
 void MySQLWorker::WorkerLoop() {
+    CurrentThread::setName("MySQLWorker");
+    if (!CurrentThread::setAffinity(cpus_)) {
+        LOG_WARN("[MySQLWorker] Set cpu affinity failed: {}", errno);
+    }
     std::shared_ptr<SQLOperation> task;
-    while (running_ && queue_->Pop(task)) {
+    while (running_) {
+        if (idle_ping_interval_.count() > 0) {
+            bool timedOut = false;
+            if (!queue_->PopFor(task, idle_ping_interval_, &timedOut)) {
+                if (!timedOut)
+                    break;  // 队列已停止
+                if (!conn_->Ping()) {  // 空闲心跳：失败时标记失效，下一个任务到来前重连
+                    LOG_WARN("[MySQLWorker] Idle ping failed, connection marked invalid");
+                }
+                continue;
+            }
+        } else if (!queue_->Pop(task)) {
+            break;
+        }
         if (!task) continue;
 
         if (!conn_->IsAlive()) {
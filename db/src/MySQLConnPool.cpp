@@ -2,6 +2,10 @@
 
 #include <cppconn/exception.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
 #include "LogMacros.h"
 
 // ------------------ 静态成员定义 ------------------
@@ -39,8 +43,6 @@ void MySQLConnPool::InitPool(const MySQLConnInfo& info, int initial_size, int ma
 
     CreateInitialConnections(info);
     SpawnWorkerThreads();
-
-    StartKeepAlive();
 }
 
 void MySQLConnPool::CreateInitialConnections(const MySQLConnInfo& info) {
@@ -57,8 +59,12 @@ void MySQLConnPool::CreateInitialConnections(const MySQLConnInfo& info) {
 
 void MySQLConnPool::SpawnWorkerThreads() {
     std::lock_guard<std::mutex> lock(pool_mtx_);
+    // 心跳由各 worker 在空闲时对自己的连接完成，Ping 是阻塞调用，不能放到 EventLoop 定时器里
+    const std::chrono::seconds pingInterval(std::max(5, max_idle_time_ / 2));
     for (auto& conn : conns_) {
         auto worker = std::make_unique<MySQLWorker>(conn, queue_);
+        worker->SetCpuAffinity(worker_cpus_);
+        worker->SetIdlePingInterval(pingInterval);
         worker->Start();
         workers_.push_back(std::move(worker));
     }
@@ -106,36 +112,5 @@ void MySQLConnPool::Shutdown() {
         workers_.clear();
         conns_.clear();
     }
-    StopKeepAlive();  // 停止心跳线程
     std::cout << "[MySQLConnPool] Shutdown completed for " << database_ << std::endl;
 }
-
-void MySQLConnPool::StartKeepAlive() {
-    running_ = true;
-    keepalive_thread_ = std::thread(&MySQLConnPool::KeepAliveLoop, this);
-}
-
-void MySQLConnPool::StopKeepAlive() {
-    running_ = false;
-    if (keepalive_thread_.joinable())
-        keepalive_thread_.join();
-}
-
-void MySQLConnPool::KeepAliveLoop() {
-    using namespace std::chrono_literals;
-    const auto interval = std::chrono::seconds(std::max(5, max_idle_time_ / 2));
-
-    while (running_) {
-        {
-            std::lock_guard<std::mutex> lock(pool_mtx_);
-            for (auto& conn : conns_) {
-                if (!conn.unique()) continue; // 跳过被 Worker 持用的
-                if (!conn->Ping()) {
-                    LOG_WARN("[KeepAlive] Mark connection invalid {}", static_cast<const void*>(conn.get()));
-                }
-            }
-        }
-        std::this_thread::sleep_for(interval);
-    }
-}
-
@@ -10,6 +10,7 @@
 #include <iostream>
 
 #include "Buffer.h"
+#include "CurrentThread.h"
 
 AsyncFileSink::AsyncFileSink(const std::string& path, Options opt) : opt_(opt), queue_(std::make_unique<MPSCAtomicQueue<std::string>>()) {
     fd_ = ::open(path.c_str(), O_CREAT | O_APPEND | O_WRONLY | O_CLOEXEC, 0644);
@@ -58,6 +59,9 @@ void AsyncFileSink::flush_all_now() {
 }
 
 void AsyncFileSink::run() {
+    CurrentThread::setName("AsyncLog");
+    CurrentThread::setAffinity(opt_.cpu_affinity);  // 日志线程自身不能可靠地写日志，失败时静默
+
     using clock = std::chrono::steady_clock;
     auto next_sync = clock::now() + std::chrono::milliseconds(opt_.sync_interval_ms);
 
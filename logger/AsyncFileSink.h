@@ -2,9 +2,12 @@
 
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "MPSCQueue.h"
 
+// 日志落盘保留独立后台线程：logger 位于 core 之下（EventLoop 本身依赖日志），
+// 且 write/fdatasync 是阻塞调用，放进任何 EventLoop 定时器都会卡住该 loop 的全部连接
 class AsyncFileSink {
 public:
     struct Options {
@@ -12,6 +15,7 @@ public:
         size_t batch_iov_max = 1024;  // 单批最多写多少条日志
         int sync_interval_ms = 1000;  // 定时刷盘间隔（毫秒）
         bool use_fdatasync = true;  // true = fdatasync, false = fsync
+        std::vector<int> cpu_affinity;  // 后台线程绑核列表，空表示不绑定
         Options() {}
         Options(size_t sb, size_t bi, int si, bool uf) : sync_bytes(sb), batch_iov_max(bi), sync_interval_ms(si), use_fdatasync(uf) {}
     };
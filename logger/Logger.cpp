@@ -1,13 +1,13 @@
 #include "Logger.h"
 
 #include <chrono>
-#include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <thread>
 
 #include "AsyncFileSink.h"
+#include "WallClock.h"
 namespace {
 std::string_view basename_view(std::string_view path) {
     const size_t pos = path.find_last_of("/\\");
@@ -101,16 +101,12 @@ void Logger::log(LogLevel level, std::string_view msg) {
 
     std::ostringstream oss;
     const auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-#if defined(_WIN32)
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
-
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << ms.count() << " [tid:0x" << std::hex << std::this_thread::get_id() << "] "
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+    auto ms = sinceEpoch % 1000;
+    // 日期时间部分按秒缓存，同一秒内的日志行不再调用 localtime_r
+    std::string_view dateTime = WallClock::localTime(std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count());
+
+    oss << dateTime << '.' << std::setfill('0') << std::setw(3) << ms.count() << " [tid:0x" << std::hex << std::this_thread::get_id() << "] "
         << "[" << levelToString(level) << "] " << msg << "\n";
 
     std::string out = oss.str();
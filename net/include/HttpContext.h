@@ -19,6 +19,7 @@ public:
     bool parseRequest(Buffer* buf, Timestamp receiveTime);
 
     bool gotAll() const { return state_ == kGotAll; }
+    bool expectingRequest() const { return state_ == kExpectRequestLine; }  // 尚未开始解析下一个请求
     void reset();
 
     const HttpRequest& request() const { return request_; }
@@ -2,6 +2,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
+
+#include "BufferSlice.h"
 
 class Buffer;
 
@@ -40,9 +43,14 @@ public:
     void setContentType(const std::string& contentType) { addHeader("Content-Type", contentType); }
     void addHeader(const std::string& key, const std::string& value) { headers_[key] = value; }
 
-    void setBody(const std::string& body) { body_ = body; }
+    void setBody(const std::string& body) { body_ = BufferSlice(std::string(body)); }
+    void setBody(std::string&& body) { body_ = BufferSlice(std::move(body)); }
+    void setBody(BufferSlice body) { body_ = std::move(body); }  // 共享缓存内容，不拷贝
+    const BufferSlice& body() const { return body_; }
 
     void appendToBuffer(Buffer* output) const;
+    std::string headerString() const;  // 状态行 + 头部 + 空行
+    std::vector<BufferSlice> toSlices() const { return {BufferSlice(headerString()), body_}; }  // 供 TcpConnection 零拷贝发送
     void setStatusLine(const std::string& version, HttpStatusCode statusCode, const std::string& statusMessage);
     // void setErrorHeader() {}
 
@@ -51,6 +59,6 @@ private:
     HttpStatusCode statusCode_;
     std::string statusMessage_;
     std::map<std::string, std::string> headers_;
-    std::string body_;
+    BufferSlice body_;
     bool closeConnection_;
 };
@@ -28,11 +28,41 @@ public:
     // 由外部注入 EventLoop（避免自持 mainLoop_ 带来的耦合）
     HttpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name, bool useTLS = false, TcpServer::Option option = TcpServer::kNoReusePort);
 
+    // 热重启：由已绑定的监听fd构造（见 HotRestart），其余监听fd用 addListenFd 追加
+    HttpServer(EventLoop* loop, int listenFd, const std::string& name, bool useTLS = false, TcpServer::Option option = TcpServer::kNoReusePort);
+    ~HttpServer();  // 需在 loop 线程析构：撤销引用本对象的会话清理定时器
+
+    // 追加监听地址（IPv6、Unix域等），需在 start() 之前调用
+    void addListenAddress(const InetAddress& listenAddr) { server_.addListenAddress(listenAddr); }
+    void addListenFd(int listenFd) { server_.addListenFd(listenFd); }
+    std::vector<int> listenFds() const { return server_.listenFds(); }  // 交给新进程的监听fd
+
+    // 监听/连接套接字选项（backlog、TCP_DEFER_ACCEPT、TCP_FASTOPEN、NODELAY等），需在 start() 之前设置
+    void setSocketOptions(const SocketOptions& opts) { server_.setSocketOptions(opts); }
+
     // 线程配置/启动
     void setThreadNum(int n) { server_.setThreadNum(n); }
+    void setThreadCpuList(std::vector<int> cpus) { server_.setThreadCpuList(std::move(cpus)); }
+
+    // 连接超时（秒），请求头超时从建连或新请求首字节开始计时，读完完整请求后取消
+    void setIdleTimeout(double seconds) { server_.setIdleTimeout(seconds); }
+    void setHeaderReadTimeout(double seconds) { server_.setHeaderReadTimeout(seconds); }
+    void setWriteStallTimeout(double seconds) { server_.setWriteStallTimeout(seconds); }
+    // 边缘触发模式（epoll后端），需在 start() 之前设置
+    void setEdgeTriggered(bool on) { server_.setEdgeTriggered(on); }
+    // 大响应体走 MSG_ZEROCOPY（字节阈值，0表示关闭），需在 start() 之前设置
+    void setZeroCopyThreshold(size_t threshold) { server_.setZeroCopyThreshold(threshold); }
+    // 输出积压读反压（默认 1MB/256KB，防止只发不收的流水线客户端撑爆响应缓冲），需在 start() 之前设置
+    void setOutputBackpressure(size_t highMark, size_t lowMark) { server_.setOutputBackpressure(highMark, lowMark); }
+    void setOutputMemoryBudget(size_t bytes) { server_.setOutputMemoryBudget(bytes); }
     
     void start();
     void stop();
+    // 优雅停机（线程安全）：关闭监听（listenFdsHandedOver 时只停止accept，见 TcpServer::drain），空闲连接立即关闭，
+    // 处理中的请求以 Connection: close 响应后关闭，全部关闭或超过 timeoutSeconds 后调用 stop()
+    void drain(double timeoutSeconds, bool listenFdsHandedOver = false);
+    bool draining() const { return server_.draining(); }
+    size_t numConnections() const { return server_.numConnections(); }
 
     // 业务回调（兜底）
     void setHttpCallback(const HttpCallback& cb) { httpCallback_ = cb; }
@@ -59,6 +89,9 @@ public:
     void setTlsContext(std::shared_ptr<TLSContext> ctx) { tlsCtx_ = std::move(ctx); }
 
 private:
+    void setupCallbacks();  // 两个构造函数共用
+    void cancelSessionCleanTimer();
+
     // —— 事件派发（统一入口）——
     void onConnection(const TcpConnectionPtr& conn);
     void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp ts);
@@ -80,6 +113,7 @@ private:
     std::unique_ptr<SessionManager> sessionMgr_;
 
     HttpCallback httpCallback_;  // 兜底业务回调
+    TimerId sessionCleanTimer_;  // 过期会话定时清理
     bool useTLS_{false};
     std::shared_ptr<TLSContext> tlsCtx_;  // 线程安全共享
     
@@ -1,10 +1,11 @@
 #pragma once
-#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 
+#include "Timestamp.h"
+
 class SessionManager;
 
 class Session : public std::enable_shared_from_this<Session> {
@@ -29,7 +30,7 @@ private:
     mutable std::mutex mutex_;
     std::unordered_map<std::string, std::string> data_;
 
-    std::chrono::system_clock::time_point expiryTime_;
+    MonoTimestamp expiryTime_;  // 单调时钟，系统时间跳变不影响过期判断
     int maxAge_;
 
     std::weak_ptr<SessionManager> manager_;
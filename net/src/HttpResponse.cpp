@@ -1,36 +1,50 @@
 #include "HttpResponse.h"
 
 #include <cstdio>
-#include <cstring>
 
 #include "Buffer.h"
+#include "WallClock.h"
 
 HttpResponse::HttpResponse(bool close) : statusCode_(kUnknown), closeConnection_(close) {}
 
 void HttpResponse::appendToBuffer(Buffer* output) const {
+    const std::string header = headerString();
+    output->append(header.data(), header.size());
+    output->append(body_.data(), body_.size());
+}
+
+std::string HttpResponse::headerString() const {
+    std::string output;
+    output.reserve(128 + statusMessage_.size());
     char buf[64];
     snprintf(buf, sizeof buf, "HTTP/1.1 %d ", statusCode_);
-    output->append(buf, strlen(buf));
-    output->append(statusMessage_.c_str(), statusMessage_.size());
-    output->append("\r\n", 2);
+    output.append(buf);
+    output.append(statusMessage_);
+    output.append("\r\n", 2);
 
     if (closeConnection_) {
-        output->append("Connection: close\r\n", 19);
+        output.append("Connection: close\r\n", 19);
     } else {
         snprintf(buf, sizeof buf, "Content-Length: %zu\r\n", body_.size());
-        output->append(buf, strlen(buf));
-        output->append("Connection: Keep-Alive\r\n", 24);
+        output.append(buf);
+        output.append("Connection: Keep-Alive\r\n", 24);
+    }
+
+    if (!headers_.contains("Date")) {
+        output.append("Date: ", 6);
+        output.append(WallClock::httpDate());  // 按秒缓存的格式化结果
+        output.append("\r\n", 2);
     }
 
     for (const auto& header : headers_) {
-        output->append(header.first.c_str(), header.first.size());
-        output->append(": ", 2);
-        output->append(header.second.c_str(), header.second.size());
-        output->append("\r\n", 2);
+        output.append(header.first);
+        output.append(": ", 2);
+        output.append(header.second);
+        output.append("\r\n", 2);
     }
 
-    output->append("\r\n", 2);
-    output->append(body_.c_str(), body_.size());
+    output.append("\r\n", 2);
+    return output;
 }
 
 void HttpResponse::setStatusLine(const std::string& version, HttpStatusCode statusCode, const std::string& statusMessage) {
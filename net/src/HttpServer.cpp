@@ -6,30 +6,80 @@
 
 using namespace std;
 
+namespace {
+const double kSessionCleanInterval = 60.0;  // 过期会话清理周期（秒）
+const size_t kOutputHighMark = 1024 * 1024;  // 默认输出积压读反压阈值
+const size_t kOutputLowMark = 256 * 1024;
+
+// 两个请求之间的keep-alive连接：没有未解析的输入，也没有解析到一半的请求
+bool isIdleHttpConnection(const TcpConnectionPtr& conn) {
+    if (conn->inputBuffer()->readableBytes() > 0) {
+        return false;
+    }
+    const auto* context = std::any_cast<HttpContext>(&conn->getContext());
+    return context == nullptr || context->expectingRequest();
+}
+}  // namespace
+
 // ==========================
 //  http::HttpServer 实现
 // ==========================
 
 HttpServer::HttpServer(EventLoop* loop, const InetAddress& listenAddr, const string& name, bool useTLS, TcpServer::Option option) : server_(loop, listenAddr, name, option), useTLS_(useTLS) {
+    setupCallbacks();
+}
+
+HttpServer::HttpServer(EventLoop* loop, int listenFd, const string& name, bool useTLS, TcpServer::Option option) : server_(loop, listenFd, name, option), useTLS_(useTLS) {
+    setupCallbacks();
+}
+
+HttpServer::~HttpServer() {
+    cancelSessionCleanTimer();  // loop 可能在本对象析构后继续运行，定时器回调捕获了 this
+}
+
+void HttpServer::setupCallbacks() {
     // 注册连接与消息回调
     server_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
 
     server_.setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp ts) { onMessage(conn, buf, ts); });
+    server_.setOutputBackpressure(kOutputHighMark, kOutputLowMark);
+    // 排空时立即关闭空闲连接；处理中的连接在下一个响应带上 Connection: close 后关闭
+    server_.setConnectionDrainCallback([](const TcpConnectionPtr& conn) {
+        if (isIdleHttpConnection(conn)) {
+            conn->shutdown();
+        }
+    });
 }
 
 void HttpServer::start() {
     if (useTLS_ && !tlsCtx_) {
         LOG_FATAL("TLS enabled but no TLSContext provided");
     }
+    if (sessionMgr_) {
+        // 由 mainLoop 的定时器周期清理过期会话，无需额外线程
+        sessionCleanTimer_ = server_.getLoop()->runEvery(kSessionCleanInterval, [this] { sessionMgr_->cleanExpiredSessions(); });
+    }
     server_.start();
 }
 
+void HttpServer::drain(double timeoutSeconds, bool listenFdsHandedOver) {
+    LOG_INFO("[HttpServer] Draining connections...");
+    server_.drain(timeoutSeconds, [this] { stop(); }, listenFdsHandedOver);
+}
+
 void HttpServer::stop() {
     LOG_INFO("[HttpServer] Stopping server...");
+    cancelSessionCleanTimer();
     server_.stop();
     LOG_INFO("[HttpServer] Shutdown complete");
 }
 
+void HttpServer::cancelSessionCleanTimer() {
+    if (sessionCleanTimer_.valid()) {
+        server_.getLoop()->cancel(sessionCleanTimer_);
+        sessionCleanTimer_ = TimerId();
+    }
+}
 
 void HttpServer::onConnection(const TcpConnectionPtr& conn) {
     if (conn->connected()) {
@@ -92,21 +142,22 @@ void HttpServer::onPlainMessage(const TcpConnectionPtr& conn, Buffer* buf, Times
         HttpResponse resp(false);
         resp.setStatusCode(HttpResponse::k400BadRequest);
         resp.setStatusMessage("Bad Request");
-        Buffer out;
-        resp.appendToBuffer(&out);
-        conn->send(&out);
+        conn->send(resp.toSlices());
         conn->shutdown();
         return;
     }
 
     if (context->gotAll()) {
+        conn->cancelReadTimeout();  // 完整请求已读完
         handleHttpRequest(conn, context->request());
         context->reset();  // 为下一次请求复用
+    } else {
+        conn->startReadTimeout();  // 请求未读完：从首个字节开始计时，已在计时则不延长
     }
 }
 
 void HttpServer::handleHttpRequest(const TcpConnectionPtr& conn, HttpRequest& req) {
-    HttpResponse resp(req.getHeader("Connection") == "close");
+    HttpResponse resp(req.getHeader("Connection") == "close" || server_.draining());  // 排空期间处理完本请求即关闭
 
     // 会话管理（若启用）
     if (sessionMgr_) {
@@ -116,9 +167,7 @@ void HttpServer::handleHttpRequest(const TcpConnectionPtr& conn, HttpRequest& re
     // 中间件链执行
     bool cont = middlewares_.handle(req, resp);
     if (!cont) {
-        Buffer out;
-        resp.appendToBuffer(&out);
-        conn->send(&out);
+        conn->send(resp.toSlices());
         if (resp.closeConnection())
             conn->shutdown();
         return;
@@ -139,9 +188,7 @@ void HttpServer::handleHttpRequest(const TcpConnectionPtr& conn, HttpRequest& re
         resp.setBody("404 Not Found");
     }
 
-    Buffer out;
-    resp.appendToBuffer(&out);
-    conn->send(&out);
+    conn->send(resp.toSlices());  // 响应头与响应体分片 writev，不再拼接拷贝
     if (resp.closeConnection())
         conn->shutdown();
 }
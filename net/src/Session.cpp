@@ -1,21 +1,20 @@
 #include "Session.h"
 
-#include <chrono>
-
+#include "EventLoop.h"
 #include "SessionManager.h"
 
 Session::Session(const std::string& sessionId, std::weak_ptr<SessionManager> manager, int maxAge) : sessionId_(sessionId), maxAge_(maxAge), manager_(std::move(manager)) {
     refresh();
 }
 
-// 检查会话是否已过期
+// 检查会话是否已过期（在loop线程中读取本轮缓存的时间）
 bool Session::isExpired() const {
-    return std::chrono::system_clock::now() > expiryTime_;
+    return expiryTime_ < EventLoop::cachedNow();
 }
 
 // 刷新会话的过期时间
 void Session::refresh() {
-    expiryTime_ = std::chrono::system_clock::now() + std::chrono::seconds(maxAge_);
+    expiryTime_ = addTime(EventLoop::cachedNow(), maxAge_);
 }
 
 // 设置键值
@@ -0,0 +1,154 @@
+#include <stddef.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "InetAddress.h"
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            ::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                           \
+        }                                                                           \
+    } while (0)
+
+const socklen_t kUnixPathOffset = offsetof(sockaddr_un, sun_path);
+const size_t kMaxUnixPath = sizeof(sockaddr_un::sun_path) - 1;
+
+// 解析成功后再按 toIpPort() 解析一次，应得到相同的地址
+void checkRoundTrip(const InetAddress& addr) {
+    InetAddress again;
+    CHECK(InetAddress::parse(addr.toIpPort(), &again));
+    CHECK(again == addr);
+}
+
+void testIpv4() {
+    InetAddress addr;
+    CHECK(InetAddress::parse("127.0.0.1:8080", &addr));
+    CHECK(addr.family() == AF_INET);
+    CHECK(addr.toIp() == "127.0.0.1");
+    CHECK(addr.toPort() == 8080);
+    CHECK(addr.toIpPort() == "127.0.0.1:8080");
+    CHECK(addr.getSockLen() == sizeof(sockaddr_in));
+    checkRoundTrip(addr);
+
+    CHECK(InetAddress::parse("0.0.0.0:0", &addr));
+    CHECK(addr.toPort() == 0);
+    CHECK(InetAddress::parse("10.0.0.1:65535", &addr));
+    CHECK(addr.toPort() == 65535);
+}
+
+void testIpv6() {
+    InetAddress addr;
+    CHECK(InetAddress::parse("[::1]:80", &addr));
+    CHECK(addr.isIpv6());
+    CHECK(addr.toIp() == "::1");
+    CHECK(addr.toPort() == 80);
+    CHECK(addr.toIpPort() == "[::1]:80");
+    CHECK(addr.getSockLen() == sizeof(sockaddr_in6));
+    checkRoundTrip(addr);
+
+    CHECK(InetAddress::parse("[::]:0", &addr));
+    CHECK(addr.isIpv6());
+    CHECK(addr.toIp() == "::");
+
+    CHECK(InetAddress::parse("[fe80::1:2]:443", &addr));
+    CHECK(addr.toIp() == "fe80::1:2");
+    CHECK(addr.toPort() == 443);
+    checkRoundTrip(addr);
+
+    CHECK(InetAddress::parse("[::ffff:1.2.3.4]:8080", &addr));
+    CHECK(addr.isIpv6());
+    CHECK(addr.toPort() == 8080);
+}
+
+void testUnixPath() {
+    InetAddress addr;
+    CHECK(InetAddress::parse("unix:/tmp/a.sock", &addr));
+    CHECK(addr.isUnix());
+    CHECK(!addr.isAbstract());
+    CHECK(addr.toIp() == "/tmp/a.sock");
+    CHECK(addr.toPort() == 0);
+    CHECK(addr.toIpPort() == "unix:/tmp/a.sock");
+    CHECK(addr.getSockLen() == kUnixPathOffset + std::string("/tmp/a.sock").size() + 1);
+    checkRoundTrip(addr);
+
+    // 文件路径须保留结尾'\0'，最长 sizeof(sun_path) - 1
+    const std::string longest(kMaxUnixPath, 'p');
+    CHECK(InetAddress::parse("unix:" + longest, &addr));
+    CHECK(addr.toIp() == longest);
+    CHECK(!InetAddress::parse("unix:" + longest + "p", &addr));
+}
+
+void testAbstractUnix() {
+    InetAddress addr;
+    CHECK(InetAddress::parse("unix:@name", &addr));
+    CHECK(addr.isUnix());
+    CHECK(addr.isAbstract());
+    CHECK(addr.toIp() == "@name");
+    CHECK(addr.toIpPort() == "unix:@name");
+    // 抽象名字按长度区分，不含结尾'\0'：长度须精确，否则与 "name\0" 是不同的地址
+    CHECK(addr.getSockLen() == kUnixPathOffset + 1 + 4);
+    checkRoundTrip(addr);
+
+    InetAddress other;
+    CHECK(InetAddress::parse("unix:@name2", &other));
+    CHECK(!(other == addr));
+    CHECK(InetAddress::parse("unix:/name", &other));
+    CHECK(!(other == addr));
+
+    // 首字节'\0'占去一个位置后，名字最长同样为 sizeof(sun_path) - 1
+    const std::string longest(kMaxUnixPath, 'n');
+    CHECK(InetAddress::parse("unix:@" + longest, &addr));
+    CHECK(addr.getSockLen() == kUnixPathOffset + 1 + kMaxUnixPath);
+    CHECK(!InetAddress::parse("unix:@" + longest + "n", &addr));
+}
+
+void testInvalid() {
+    const char* const kInvalid[] = {
+        "",
+        "127.0.0.1",
+        "127.0.0.1:",
+        ":80",
+        "127.0.0.1:65536",
+        "127.0.0.1:-1",
+        "127.0.0.1:80x",
+        "127.0.0.1: 80",
+        "256.0.0.1:80",
+        "localhost:80",
+        "::1:80",  // IPv6 须写成 [addr]:port
+        "[::1]80",
+        "[::1]:",
+        "[::1:80",
+        "[1.2.3.4]:80",
+        "unix:",
+        "unix:@",
+    };
+    for (const char* spec : kInvalid) {
+        InetAddress addr("1.2.3.4", 5);
+        if (InetAddress::parse(spec, &addr)) {
+            ::fprintf(stderr, "parse(\"%s\") unexpectedly succeeded\n", spec);
+            ++g_failures;
+        }
+        CHECK(addr.toIpPort() == "1.2.3.4:5");  // 失败时不修改输出
+    }
+}
+}  // namespace
+
+int main() {
+    testIpv4();
+    testIpv6();
+    testUnixPath();
+    testAbstractUnix();
+    testInvalid();
+    if (g_failures > 0) {
+        ::fprintf(stderr, "InetAddressTest: %d checks failed\n", g_failures);
+        return 1;
+    }
+    ::printf("InetAddressTest: all passed\n");
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "BufferSlice.h"
+#include "OutputChain.h"
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            ::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                           \
+        }                                                                           \
+    } while (0)
+
+// 非阻塞的本地流套接字对：向 fds[0] 写，从 fds[1] 读；sendBuffer > 0 时缩小发送缓冲以制造短写
+struct SocketPair {
+    int fds[2] = {-1, -1};
+
+    explicit SocketPair(int sendBuffer = 0) {
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) != 0) {
+            ::perror("socketpair");
+            ::exit(1);
+        }
+        if (sendBuffer > 0) {
+            ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof sendBuffer);
+        }
+    }
+    ~SocketPair() {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    int writer() const { return fds[0]; }
+    // 读出当前可读的全部数据
+    std::string drain() const {
+        std::string out;
+        char buf[65536];
+        ssize_t n = 0;
+        while ((n = ::read(fds[1], buf, sizeof buf)) > 0) {
+            out.append(buf, static_cast<size_t>(n));
+        }
+        return out;
+    }
+};
+
+// 内容为 content 的匿名临时文件
+int tempFile(const std::string& content) {
+    char path[] = "/tmp/OutputChainTestXXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd < 0 || ::unlink(path) != 0 || ::write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size())) {
+        ::perror("tempFile");
+        ::exit(1);
+    }
+    return fd;
+}
+
+std::string pattern(size_t len, char seed) {
+    std::string s(len, '\0');
+    for (size_t i = 0; i < len; ++i) {
+        s[i] = static_cast<char>(seed + static_cast<char>(i % 23));
+    }
+    return s;
+}
+
+// 反复写出并从对端读取，直到输出链清空，返回对端收到的全部数据
+std::string writeAll(OutputChain& chain, const SocketPair& pair, size_t maxBytesPerCall = SIZE_MAX) {
+    std::string received;
+    int err = 0;
+    while (!chain.empty()) {
+        chain.writeTo(pair.writer(), maxBytesPerCall, &err);
+        if (err != 0 && err != EAGAIN) {
+            ::fprintf(stderr, "writeTo failed, errno %d\n", err);
+            ++g_failures;
+            break;
+        }
+        received += pair.drain();
+    }
+    return received + pair.drain();
+}
+
+void testEmptyAppend() {
+    OutputChain chain;
+    chain.append("", 0);
+    chain.append(BufferSlice());
+    chain.appendFile(0, 0, 0);
+    CHECK(chain.empty());
+    CHECK(chain.segmentCount() == 0);
+    CHECK(chain.readableBytes() == 0);
+
+    SocketPair pair;
+    int err = -1;
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 0);
+    CHECK(err == 0);
+}
+
+// 自有段、共享段、文件段交错入队，按入队顺序写出；连续的拷贝数据合并到尾段
+void testOrderAcrossSegments() {
+    const int fileFd = tempFile("0123456789");
+    OutputChain chain;
+    chain.append("a", 1);
+    chain.append(BufferSlice(std::string("BB")));
+    chain.appendFile(fileFd, 3, 4);
+    chain.append("d", 1);
+    chain.append("e", 1);
+    CHECK(chain.segmentCount() == 4);
+    CHECK(chain.readableBytes() == 9);
+    CHECK(chain.memoryBytes() == 5);
+
+    SocketPair pair;
+    int err = -1;
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 9);
+    CHECK(err == 0);
+    CHECK(chain.empty());
+    CHECK(chain.readableBytes() == 0);
+    CHECK(chain.memoryBytes() == 0);
+    CHECK(pair.drain() == "aBB3456de");
+    ::close(fileFd);
+}
+
+// maxBytes 限制单次写出量，剩余部分保持顺序
+void testMaxBytes() {
+    const int fileFd = tempFile(pattern(100, 'f'));
+    const std::string owned = pattern(40, 'a');
+    const std::string shared = pattern(30, 'S');
+    OutputChain chain;
+    chain.append(owned.data(), owned.size());
+    chain.append(BufferSlice(std::string(shared)));
+    chain.appendFile(fileFd, 0, 100);
+
+    SocketPair pair;
+    int err = -1;
+    CHECK(chain.writeTo(pair.writer(), 25, &err) == 25);
+    CHECK(err == 0);
+    CHECK(chain.readableBytes() == 145);
+    CHECK(chain.writeTo(pair.writer(), 25, &err) == 25);  // 跨越自有段与共享段
+    CHECK(chain.readableBytes() == 120);
+    CHECK(chain.writeTo(pair.writer(), 50, &err) == 50);  // 跨越共享段与文件段
+    CHECK(chain.readableBytes() == 70);
+    CHECK(chain.memoryBytes() == 0);
+    const std::string received = pair.drain() + writeAll(chain, pair, 7);
+    CHECK(received == owned + shared + pattern(100, 'f'));
+    ::close(fileFd);
+}
+
+// 短写时停止并返回已写出的字节数，缓冲已满时再写报告 EAGAIN，之后从断点继续
+void testPartialWrite() {
+    const std::string owned = pattern(300000, 'a');
+    const std::string shared = pattern(500000, 'S');
+    const std::string tail = pattern(1000, 't');
+    const int fileFd = tempFile(pattern(200000, 'F'));
+    OutputChain chain;
+    chain.append(owned.data(), owned.size());
+    chain.append(BufferSlice(std::string(shared)));
+    chain.appendFile(fileFd, 0, 200000);
+    chain.append(tail.data(), tail.size());
+    const size_t total = chain.readableBytes();
+
+    SocketPair pair(4096);
+    int err = 0;
+    const size_t written = chain.writeTo(pair.writer(), SIZE_MAX, &err);
+    CHECK(err == 0 || err == EAGAIN);
+    CHECK(written > 0);
+    CHECK(written < total);
+    CHECK(chain.readableBytes() == total - written);
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 0);
+    CHECK(err == EAGAIN);
+    CHECK(chain.readableBytes() == total - written);
+
+    const std::string received = pair.drain() + writeAll(chain, pair);
+    CHECK(received.size() == total);
+    CHECK(received == owned + shared + pattern(200000, 'F') + tail);
+    ::close(fileFd);
+}
+
+// 自有尾段已写前缀较大时追加会回收前缀，未写出的数据不受影响
+void testOwnedTailCompaction() {
+    const std::string first = pattern(200000, 'a');
+    const std::string second = pattern(1000, 'z');
+    OutputChain chain;
+    chain.append(first.data(), first.size());
+
+    SocketPair pair;
+    int err = 0;
+    CHECK(chain.writeTo(pair.writer(), 150000, &err) == 150000);
+    std::string received = pair.drain();
+    chain.append(second.data(), second.size());
+    CHECK(chain.segmentCount() == 1);
+    CHECK(chain.readableBytes() == 51000);
+    received += writeAll(chain, pair);
+    CHECK(received == first + second);
+}
+
+// 共享段写完即释放引用；clear() 丢弃未写出的段
+void testSharedOwnerRelease() {
+    auto data = std::make_shared<const std::string>(pattern(1000, 'S'));
+    std::weak_ptr<const std::string> weak = data;
+    OutputChain chain;
+    chain.append(BufferSlice(std::move(data)));
+    CHECK(!weak.expired());
+
+    SocketPair pair;
+    int err = 0;
+    CHECK(chain.writeTo(pair.writer(), 600, &err) == 600);
+    CHECK(!weak.expired());  // 未写完
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 400);
+    CHECK(weak.expired());
+    CHECK(pair.drain() == pattern(1000, 'S'));
+
+    auto other = std::make_shared<const std::string>("pending");
+    weak = other;
+    chain.append("x", 1);
+    chain.append(BufferSlice(std::move(other)));
+    chain.clear();
+    CHECK(weak.expired());
+    CHECK(chain.empty());
+    CHECK(chain.readableBytes() == 0);
+}
+
+// 文件比登记的区间短：写完实际内容后报告 EIO 并丢弃该段，后面的数据照常写出
+void testTruncatedFile() {
+    const int fileFd = tempFile("0123456789");
+    OutputChain chain;
+    chain.appendFile(fileFd, 0, 100);
+    chain.append("end", 3);
+
+    SocketPair pair;
+    int err = 0;
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 10);
+    CHECK(err == 0);
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 0);
+    CHECK(err == EIO);
+    CHECK(chain.readableBytes() == 3);
+    CHECK(chain.writeTo(pair.writer(), SIZE_MAX, &err) == 3);
+    CHECK(err == 0);
+    CHECK(pair.drain() == "0123456789end");
+    ::close(fileFd);
+}
+
+// 超过单次 writev 段数上限的大量小片段
+void testManySmallSlices() {
+    OutputChain chain;
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        const std::string piece = std::to_string(i) + ",";
+        chain.append(BufferSlice(std::string(piece)));
+        expected += piece;
+    }
+    CHECK(chain.segmentCount() == 1000);
+    SocketPair pair;
+    CHECK(writeAll(chain, pair) == expected);
+}
+}  // namespace
+
+int main() {
+    testEmptyAppend();
+    testOrderAcrossSegments();
+    testMaxBytes();
+    testPartialWrite();
+    testOwnedTailCompaction();
+    testSharedOwnerRelease();
+    testTruncatedFile();
+    testManySmallSlices();
+    if (g_failures > 0) {
+        ::fprintf(stderr, "OutputChainTest: %d checks failed\n", g_failures);
+        return 1;
+    }
+    ::printf("OutputChainTest: all passed\n");
+    return 0;
+}